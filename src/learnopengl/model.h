@@ -12,32 +12,72 @@
 
 #include <learnopengl/mesh.h>
 #include <learnopengl/shader.h>
+#include <render/geometry_pool.h>
+#include <render/culling.h>
+#include <render/mesh_cache.h>
+#include <render/mesh_optimize.h>
+#include <render/texture_registry.h>
 
 #include <string>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <unordered_map>
 #include <vector>
 using namespace std;
 
-unsigned int TextureFromFile(const char *path, const string &directory, bool gamma = false);
+// with a registry the texture is shared process-wide (Release() it through the registry) and decoded
+// on the registry's loader threads; the upload happens on the loader's Drain()/Finish()
+unsigned int TextureFromFile(const char *path, const string &directory, bool gamma = false, TextureRegistry* registry = nullptr);
+
+// a mesh that lives in a GeometryPool instead of owning its own VAO/VBO/EBO
+struct PooledMesh
+{
+    MeshRange range;
+    unsigned int diffuse;   // first diffuse texture, 0 = none
+    Bounds bounds;          // local AABB + sphere, for frustum culling
+};
 
 class Model 
 {
 public:
     // model data 
     vector<Texture> textures_loaded;	// stores all the textures loaded so far, optimization to make sure textures aren't loaded more than once.
+    unordered_map<string, size_t> textureIndex;   // path -> textures_loaded slot
     vector<Mesh>    meshes;
+    vector<PooledMesh> pooledMeshes;    // filled instead of meshes when loaded into a pool
     string directory;
     bool gammaCorrection;
+    GeometryPool* pool;
+    TextureRegistry* textureRegistry;
+    MeshCacheWriter* cacheWriter = nullptr;   // set while a pooled import is being recorded
+    MeshOptimizeStats optimizeStats;          // pooled import: vertex cache reordering
+    vector<PoolVertex> scratchVertices;       // pooled import: reused for every mesh, freed after
+    vector<unsigned int> scratchIndices;
 
     // constructor, expects a filepath to a 3D model.
-    Model(string const &path, bool gamma = false) : gammaCorrection(gamma)
+    // with a pool the geometry is appended there (draw it through pooledMeshes, Draw() does nothing)
+    // with a registry the textures are shared with every other user and keep decoding after the
+    // constructor returns (Finish() the registry's loader before drawing)
+    Model(string const &path, bool gamma = false, GeometryPool* geometryPool = nullptr, TextureRegistry* registry = nullptr)
+        : gammaCorrection(gamma), pool(geometryPool), textureRegistry(registry)
     {
         loadModel(path);
     }
 
+    // gives the registry textures back (the last user deletes them)
+    ~Model()
+    {
+        if (!textureRegistry) return;
+        for(unsigned int i = 0; i < textures_loaded.size(); i++)
+            textureRegistry->Release(textures_loaded[i].id);
+    }
+
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+
     // draws the model, and thus all its meshes
     void Draw(Shader &shader)
     {
@@ -49,20 +89,70 @@ private:
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(string const &path)
     {
+        const unsigned int importFlags = aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace;
+        // retrieve the directory path of the filepath
+        directory = path.substr(0, path.find_last_of('/'));
+
+        // pooled meshes come from the binary cache when it is still valid
+        if (pool && loadCachedModel(path, importFlags))
+            return;
+
         // read file via ASSIMP
         Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+        const aiScene* scene = importer.ReadFile(path, importFlags);
         // check for errors
         if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
         {
             cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << endl;
             return;
         }
-        // retrieve the directory path of the filepath
-        directory = path.substr(0, path.find_last_of('/'));
+
+        // the pool stages the whole scene: size it once instead of growing mesh by mesh
+        if (pool)
+        {
+            size_t numVertices = 0, numIndices = 0;
+            for(unsigned int i = 0; i < scene->mNumMeshes; i++)
+            {
+                numVertices += scene->mMeshes[i]->mNumVertices;
+                numIndices += CountIndices(scene->mMeshes[i]);
+            }
+            pool->Reserve(numVertices, numIndices);
+            pooledMeshes.reserve(pooledMeshes.size() + scene->mNumMeshes);
+        }
 
         // process ASSIMP's root node recursively
+        MeshCacheWriter writer;
+        cacheWriter = pool ? &writer : nullptr;
         processNode(scene->mRootNode, scene);
+        cacheWriter = nullptr;
+        vector<PoolVertex>().swap(scratchVertices);
+        vector<unsigned int>().swap(scratchIndices);
+        if (pool)
+            optimizeStats.Print(cout);
+        if (pool && writer.Save(path, importFlags))
+            cout << "Mesh cache: wrote " << pooledMeshes.size() << " meshes to " << MeshCache::CachePath(path) << endl;
+    }
+
+    // fills pooledMeshes straight from <path>.meshcache; false = re-import
+    bool loadCachedModel(string const &path, unsigned int importFlags)
+    {
+        MeshCache cache;
+        if (!cache.Open(path, importFlags))
+            return false;
+        // hand the mapped vertices/indices to the pool as is (no conversion)
+        const vector<CachedMesh>& cached = cache.Meshes();
+        pooledMeshes.reserve(cached.size());
+        for (size_t i = 0; i < cached.size(); i++)
+        {
+            const CachedMesh& m = cached[i];
+            PooledMesh pooled;
+            pooled.range = pool->Add(m.vertices, m.vertexCount, m.indices, m.indexCount, m.mode);
+            pooled.diffuse = m.diffuse.empty() ? 0 : loadTexture(m.diffuse.c_str(), "texture_diffuse").id;
+            pooled.bounds = m.bounds;
+            pooledMeshes.push_back(pooled);
+        }
+        cout << "Mesh cache: loaded " << cached.size() << " meshes from " << MeshCache::CachePath(path) << endl;
+        return true;
     }
 
     // processes a node in a recursive fashion. Processes each individual mesh located at the node and repeats this process on its children nodes (if any).
@@ -74,7 +164,10 @@ private:
             // the node object only contains indices to index the actual objects in the scene. 
             // the scene contains all the data, node is just to keep stuff organized (like relations between nodes).
             aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-            meshes.push_back(processMesh(mesh, scene));
+            if (pool)
+                pooledMeshes.push_back(processPooledMesh(mesh, scene));
+            else
+                meshes.push_back(processMesh(mesh, scene));
         }
         // after we've processed all of the meshes (if any) we then recursively process each of the children nodes
         for(unsigned int i = 0; i < node->mNumChildren; i++)
@@ -91,57 +184,44 @@ private:
         vector<unsigned int> indices;
         vector<Texture> textures;
 
-        // walk through each of the mesh's vertices
-        for(unsigned int i = 0; i < mesh->mNumVertices; i++)
+        // one attribute at a time over assimp's contiguous arrays, presence checked once per mesh
+        const unsigned int numVertices = mesh->mNumVertices;
+        vertices.resize(numVertices);
+        Vertex* out = vertices.data();
+        const aiVector3D* positions = mesh->mVertices;
+        for(unsigned int i = 0; i < numVertices; i++)
+            out[i].Position = glm::vec3(positions[i].x, positions[i].y, positions[i].z);
+        if (mesh->HasNormals())
         {
-            Vertex vertex;
-            glm::vec3 vector; // we declare a placeholder vector since assimp uses its own vector class that doesn't directly convert to glm's vec3 class so we transfer the data to this placeholder glm::vec3 first.
-            // positions
-            vector.x = mesh->mVertices[i].x;
-            vector.y = mesh->mVertices[i].y;
-            vector.z = mesh->mVertices[i].z;
-            vertex.Position = vector;
-            // normals
-            if (mesh->HasNormals())
-            {
-                vector.x = mesh->mNormals[i].x;
-                vector.y = mesh->mNormals[i].y;
-                vector.z = mesh->mNormals[i].z;
-                vertex.Normal = vector;
-            }
-            // texture coordinates
-            if(mesh->mTextureCoords[0]) // does the mesh contain texture coordinates?
+            const aiVector3D* normals = mesh->mNormals;
+            for(unsigned int i = 0; i < numVertices; i++)
+                out[i].Normal = glm::vec3(normals[i].x, normals[i].y, normals[i].z);
+        }
+        // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't
+        // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
+        if (const aiVector3D* uvs = mesh->mTextureCoords[0])
+        {
+            for(unsigned int i = 0; i < numVertices; i++)
+                out[i].TexCoords = glm::vec2(uvs[i].x, uvs[i].y);
+            if (mesh->mTangents && mesh->mBitangents)
             {
-                glm::vec2 vec;
-                // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't 
-                // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
-                vec.x = mesh->mTextureCoords[0][i].x; 
-                vec.y = mesh->mTextureCoords[0][i].y;
-                vertex.TexCoords = vec;
-                // tangent
-                vector.x = mesh->mTangents[i].x;
-                vector.y = mesh->mTangents[i].y;
-                vector.z = mesh->mTangents[i].z;
-                vertex.Tangent = vector;
-                // bitangent
-                vector.x = mesh->mBitangents[i].x;
-                vector.y = mesh->mBitangents[i].y;
-                vector.z = mesh->mBitangents[i].z;
-                vertex.Bitangent = vector;
+                const aiVector3D* tangents = mesh->mTangents;
+                const aiVector3D* bitangents = mesh->mBitangents;
+                for(unsigned int i = 0; i < numVertices; i++)
+                {
+                    out[i].Tangent = glm::vec3(tangents[i].x, tangents[i].y, tangents[i].z);
+                    out[i].Bitangent = glm::vec3(bitangents[i].x, bitangents[i].y, bitangents[i].z);
+                }
             }
-            else
-                vertex.TexCoords = glm::vec2(0.0f, 0.0f);
-
-            vertices.push_back(vertex);
         }
-        // now wak through each of the mesh's faces (a face is a mesh its triangle) and retrieve the corresponding vertex indices.
-        for(unsigned int i = 0; i < mesh->mNumFaces; i++)
+        else
         {
-            aiFace face = mesh->mFaces[i];
-            // retrieve all indices of the face and store them in the indices vector
-            for(unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);        
+            for(unsigned int i = 0; i < numVertices; i++)
+                out[i].TexCoords = glm::vec2(0.0f, 0.0f);
         }
+        // faces (triangles after aiProcess_Triangulate): exact size first, then written in place
+        indices.resize(CountIndices(mesh));
+        CopyIndices(mesh, indices.data());
         // process materials
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];    
         // we assume a convention for sampler names in the shaders. Each diffuse texture should be named
@@ -168,6 +248,82 @@ private:
         return Mesh(vertices, indices, textures);
     }
 
+    // same as processMesh, but only position/normal/uv go into the shared pool
+    PooledMesh processPooledMesh(aiMesh *mesh, const aiScene *scene)
+    {
+        // scratch buffers live for the whole import and only ever grow: no allocation per mesh
+        size_t numVertices = mesh->mNumVertices;
+        const size_t numIndices = CountIndices(mesh);
+        if (scratchVertices.size() < numVertices) scratchVertices.resize(numVertices);
+        if (scratchIndices.size() < numIndices) scratchIndices.resize(numIndices);
+        PoolVertex* vertices = scratchVertices.data();
+        unsigned int* indices = scratchIndices.data();
+
+        const aiVector3D* positions = mesh->mVertices;
+        for(size_t i = 0; i < numVertices; i++)
+            vertices[i].position = glm::vec3(positions[i].x, positions[i].y, positions[i].z);
+        const aiVector3D* normals = mesh->HasNormals() ? mesh->mNormals : nullptr;
+        if (normals)
+            for(size_t i = 0; i < numVertices; i++)
+                vertices[i].normal = glm::vec3(normals[i].x, normals[i].y, normals[i].z);
+        else
+            for(size_t i = 0; i < numVertices; i++)
+                vertices[i].normal = glm::vec3(0.0f);
+        if (const aiVector3D* uvs = mesh->mTextureCoords[0])
+            for(size_t i = 0; i < numVertices; i++)
+                vertices[i].uv = glm::vec2(uvs[i].x, uvs[i].y);
+        else
+            for(size_t i = 0; i < numVertices; i++)
+                vertices[i].uv = glm::vec2(0.0f);
+        CopyIndices(mesh, indices);
+
+        // triangles in vertex-cache order, vertices in first-use order (the cache file stores them this way too)
+        double acmr = VertexCacheACMR(indices, numIndices, numVertices);
+        OptimizeVertexCache(indices, numIndices, numVertices);
+        numVertices = OptimizeVertexFetch(vertices, numVertices, indices, numIndices);
+        optimizeStats.Count(numIndices / 3, acmr, VertexCacheACMR(indices, numIndices, numVertices));
+
+        // the pooled shader samples texture_diffuse1 only
+        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+        vector<Texture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+
+        PooledMesh pooled;
+        pooled.range = pool->Add(vertices, numVertices, indices, numIndices, GL_TRIANGLES);
+        pooled.diffuse = diffuseMaps.empty() ? 0 : diffuseMaps[0].id;
+        pooled.bounds = ComputeBounds(vertices, numVertices);
+        if (cacheWriter)
+            cacheWriter->AddMesh(vertices, numVertices, indices, numIndices, GL_TRIANGLES, pooled.bounds,
+                                 diffuseMaps.empty() ? string() : diffuseMaps[0].path);
+        return pooled;
+    }
+
+    static size_t CountIndices(const aiMesh *mesh)
+    {
+        size_t count = 0;
+        for(unsigned int i = 0; i < mesh->mNumFaces; i++)
+            count += mesh->mFaces[i].mNumIndices;
+        return count;
+    }
+
+    // faces by reference, straight into dst (CountIndices() entries)
+    static void CopyIndices(const aiMesh *mesh, unsigned int *dst)
+    {
+        const aiFace* faces = mesh->mFaces;
+        for(unsigned int i = 0; i < mesh->mNumFaces; i++)
+        {
+            const aiFace& face = faces[i];
+            if (face.mNumIndices == 3)
+            {
+                dst[0] = face.mIndices[0];
+                dst[1] = face.mIndices[1];
+                dst[2] = face.mIndices[2];
+            }
+            else
+                std::memcpy(dst, face.mIndices, face.mNumIndices * sizeof(unsigned int));
+            dst += face.mNumIndices;
+        }
+    }
+
     // checks all material textures of a given type and loads the textures if they're not loaded yet.
     // the required info is returned as a Texture struct.
     vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, string typeName)
@@ -177,37 +333,37 @@ private:
         {
             aiString str;
             mat->GetTexture(type, i, &str);
-            // check if texture was loaded before and if so, continue to next iteration: skip loading a new texture
-            bool skip = false;
-            for(unsigned int j = 0; j < textures_loaded.size(); j++)
-            {
-                if(std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0)
-                {
-                    textures.push_back(textures_loaded[j]);
-                    skip = true; // a texture with the same filepath has already been loaded, continue to next one. (optimization)
-                    break;
-                }
-            }
-            if(!skip)
-            {   // if texture hasn't been loaded already, load it
-                Texture texture;
-                texture.id = TextureFromFile(str.C_Str(), this->directory);
-                texture.type = typeName;
-                texture.path = str.C_Str();
-                textures.push_back(texture);
-                textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
-            }
+            textures.push_back(loadTexture(str.C_Str(), typeName));
         }
         return textures;
     }
+
+    // loads one texture relative to the model directory, unless it was loaded before
+    Texture loadTexture(const char *path, const string &typeName)
+    {
+        // check if texture was loaded before and if so, skip loading a new texture
+        auto it = textureIndex.find(path);
+        if(it != textureIndex.end())
+            return textures_loaded[it->second]; // a texture with the same filepath has already been loaded (optimization)
+        Texture texture;
+        texture.id = TextureFromFile(path, this->directory, false, textureRegistry);
+        texture.type = typeName;
+        texture.path = path;
+        textureIndex[texture.path] = textures_loaded.size();
+        textures_loaded.push_back(texture);  // store it as texture loaded for entire model, to ensure we won't unnecessary load duplicate textures.
+        return texture;
+    }
 };
 
 
-unsigned int TextureFromFile(const char *path, const string &directory, bool gamma)
+unsigned int TextureFromFile(const char *path, const string &directory, bool gamma, TextureRegistry* registry)
 {
     string filename = string(path);
     filename = directory + '/' + filename;
 
+    if (registry)
+        return registry->Acquire(filename);
+
     unsigned int textureID;
     glGenTextures(1, &textureID);
 
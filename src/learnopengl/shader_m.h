@@ -5,10 +5,80 @@
 #include <glm/glm.hpp>
 
 #include <string>
+#include <vector>
+#include <utility>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+// ----------------------------------------------------------------------------
+// Typed uniform handles
+// ----------------------------------------------------------------------------
+// Resolve once with Shader::uniform<T>("name"), then set(handle, value) every
+// frame: no string, no glGetUniformLocation, and no GL call at all when the
+// value is the one already in the program. The cache assumes uniforms of this
+// program only change through Shader; call invalidateUniforms() after touching
+// them with raw glUniform* calls.
+
+template <class T> struct UniformTraits;
+
+#define SHADER_UNIFORM_TRAITS(T, GLTYPE, UPLOAD)                                 \
+    template <> struct UniformTraits<T> {                                        \
+        static bool matches(GLenum type) { return type == GLTYPE; }              \
+        static void upload(GLint loc, const T& v) { UPLOAD; }                    \
+    };
+SHADER_UNIFORM_TRAITS(float,     GL_FLOAT,      glUniform1f(loc, v))
+SHADER_UNIFORM_TRAITS(glm::vec2, GL_FLOAT_VEC2, glUniform2fv(loc, 1, &v[0]))
+SHADER_UNIFORM_TRAITS(glm::vec3, GL_FLOAT_VEC3, glUniform3fv(loc, 1, &v[0]))
+SHADER_UNIFORM_TRAITS(glm::vec4, GL_FLOAT_VEC4, glUniform4fv(loc, 1, &v[0]))
+SHADER_UNIFORM_TRAITS(glm::mat2, GL_FLOAT_MAT2, glUniformMatrix2fv(loc, 1, GL_FALSE, &v[0][0]))
+SHADER_UNIFORM_TRAITS(glm::mat3, GL_FLOAT_MAT3, glUniformMatrix3fv(loc, 1, GL_FALSE, &v[0][0]))
+SHADER_UNIFORM_TRAITS(glm::mat4, GL_FLOAT_MAT4, glUniformMatrix4fv(loc, 1, GL_FALSE, &v[0][0]))
+#undef SHADER_UNIFORM_TRAITS
+
+// int covers bool and sampler uniforms as well (all set with glUniform1i)
+template <> struct UniformTraits<int> {
+    static bool matches(GLenum type)
+    {
+        switch (type)
+        {
+        case GL_INT: case GL_BOOL:
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW: case GL_SAMPLER_BUFFER:
+        case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_SAMPLER_CUBE_MAP_ARRAY: case GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW:
+        case GL_INT_SAMPLER_1D: case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE:
+        case GL_INT_SAMPLER_1D_ARRAY: case GL_INT_SAMPLER_2D_ARRAY: case GL_INT_SAMPLER_2D_RECT:
+        case GL_INT_SAMPLER_BUFFER: case GL_INT_SAMPLER_2D_MULTISAMPLE:
+        case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY: case GL_INT_SAMPLER_CUBE_MAP_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_1D: case GL_UNSIGNED_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_3D: case GL_UNSIGNED_INT_SAMPLER_CUBE:
+        case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D_RECT: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+        case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE: case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY:
+            return true;
+        default:
+            return false;
+        }
+    }
+    static void upload(GLint loc, const int& v) { glUniform1i(loc, v); }
+};
+
+template <class T>
+class Uniform
+{
+public:
+    bool valid() const { return slot >= 0; }
+private:
+    friend class Shader;
+    int slot = -1;   // index into Shader's reflected uniform table
+};
+
 class Shader
 {
 public:
@@ -69,6 +139,8 @@ public:
         glDeleteShader(vertex);
         glDeleteShader(fragment);
 
+        reflectUniforms();
+        bindUniformBlocks();
     }
     // activate the shader
     // ------------------------------------------------------------------------
@@ -76,66 +148,209 @@ public:
     { 
         glUseProgram(ID); 
     }
-    // utility uniform functions
+    // uniform blocks: a block name registered here is bound to the same
+    // binding point in every program linked afterwards (GLSL 330 has no
+    // layout(binding = N) for blocks)
+    // ------------------------------------------------------------------------
+    static void setUniformBlockBinding(const std::string &blockName, GLuint binding)
+    {
+        std::vector<std::pair<std::string, GLuint> > &table = blockBindings();
+        for (size_t i = 0; i < table.size(); ++i)
+        {
+            if (table[i].first == blockName)
+            {
+                table[i].second = binding;
+                return;
+            }
+        }
+        table.push_back(std::make_pair(blockName, binding));
+    }
+    // typed uniform handles (resolved once, see Uniform<T> above)
+    // ------------------------------------------------------------------------
+    // returns an invalid handle (set() is then a no-op) if the program has no
+    // active uniform of that name or its GLSL type does not match T
+    template <class T>
+    Uniform<T> uniform(const std::string &name) const
+    {
+        Uniform<T> h;
+        int slot = findUniform(name);
+        if (slot < 0)
+            return h;
+        if (!UniformTraits<T>::matches(uniforms[slot].type))
+        {
+            std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH: " << name << std::endl;
+            return h;
+        }
+        h.slot = slot;
+        return h;
+    }
+    // the program must be in use, as with the glUniform* calls it replaces
+    template <class T>
+    void set(Uniform<T> h, const T &value) const
+    {
+        if (h.slot >= 0)
+            store(uniforms[h.slot], value);
+    }
+    // forget cached values (after raw glUniform* calls on this program)
+    void invalidateUniforms() const
+    {
+        for (size_t i = 0; i < uniforms.size(); ++i)
+            uniforms[i].cached = false;
+    }
+    // utility uniform functions: by-name slow path, same cache as set()
     // ------------------------------------------------------------------------
     void setBool(const std::string &name, bool value) const
     {         
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+        setByName(name, (int)value); 
     }
     // ------------------------------------------------------------------------
     void setInt(const std::string &name, int value) const
     { 
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+        setByName(name, value); 
     }
     // ------------------------------------------------------------------------
     void setFloat(const std::string &name, float value) const
     { 
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+        setByName(name, value); 
     }
     // ------------------------------------------------------------------------
     void setVec2(const std::string &name, const glm::vec2 &value) const
     { 
-        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        setByName(name, value); 
     }
     void setVec2(const std::string &name, float x, float y) const
     { 
-        glUniform2f(glGetUniformLocation(ID, name.c_str()), x, y); 
+        setByName(name, glm::vec2(x, y)); 
     }
     // ------------------------------------------------------------------------
     void setVec3(const std::string &name, const glm::vec3 &value) const
     { 
-        glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        setByName(name, value); 
     }
     void setVec3(const std::string &name, float x, float y, float z) const
     { 
-        glUniform3f(glGetUniformLocation(ID, name.c_str()), x, y, z); 
+        setByName(name, glm::vec3(x, y, z)); 
     }
     // ------------------------------------------------------------------------
     void setVec4(const std::string &name, const glm::vec4 &value) const
     { 
-        glUniform4fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]); 
+        setByName(name, value); 
     }
     void setVec4(const std::string &name, float x, float y, float z, float w) const
     { 
-        glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+        setByName(name, glm::vec4(x, y, z, w)); 
     }
     // ------------------------------------------------------------------------
     void setMat2(const std::string &name, const glm::mat2 &mat) const
     {
-        glUniformMatrix2fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setByName(name, mat);
     }
     // ------------------------------------------------------------------------
     void setMat3(const std::string &name, const glm::mat3 &mat) const
     {
-        glUniformMatrix3fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setByName(name, mat);
     }
     // ------------------------------------------------------------------------
     void setMat4(const std::string &name, const glm::mat4 &mat) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        setByName(name, mat);
     }
 
 private:
+    // one active uniform of the linked program, with its last uploaded value
+    struct UniformSlot
+    {
+        std::string   name;
+        GLint         location;
+        GLenum        type;
+        bool          cached;
+        bool          mismatchReported;   // by-name type errors are printed once
+        unsigned char value[sizeof(glm::mat4)];
+    };
+    mutable std::vector<UniformSlot> uniforms;
+
+    static std::vector<std::pair<std::string, GLuint> > &blockBindings()
+    {
+        static std::vector<std::pair<std::string, GLuint> > table;
+        return table;
+    }
+    void bindUniformBlocks()
+    {
+        std::vector<std::pair<std::string, GLuint> > &table = blockBindings();
+        for (size_t i = 0; i < table.size(); ++i)
+        {
+            GLuint index = glGetUniformBlockIndex(ID, table[i].first.c_str());
+            if (index != GL_INVALID_INDEX)
+                glUniformBlockBinding(ID, index, table[i].second);
+        }
+    }
+
+    // program reflection: every active default-block uniform, once, after link
+    // ------------------------------------------------------------------------
+    void reflectUniforms()
+    {
+        uniforms.clear();
+        GLint count = 0, maxLen = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+        std::vector<GLchar> buf(maxLen > 0 ? maxLen : 1);
+        for (GLint i = 0; i < count; ++i)
+        {
+            GLsizei len = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(ID, (GLuint)i, (GLsizei)buf.size(), &len, &size, &type, buf.data());
+            std::string name(buf.data(), len);
+            GLint loc = glGetUniformLocation(ID, name.c_str());
+            if (loc < 0)
+                continue; // uniform block member
+            // arrays are reported as "name[0]"; element 0 is what name-based lookup hits
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+                name.resize(name.size() - 3);
+            UniformSlot u;
+            u.name = name;
+            u.location = loc;
+            u.type = type;
+            u.cached = false;
+            u.mismatchReported = false;
+            uniforms.push_back(u);
+        }
+    }
+    int findUniform(const std::string &name) const
+    {
+        for (size_t i = 0; i < uniforms.size(); ++i)
+            if (uniforms[i].name == name)
+                return (int)i;
+        return -1;
+    }
+    template <class T>
+    void store(UniformSlot &u, const T &value) const
+    {
+        static_assert(sizeof(T) <= sizeof(u.value), "uniform value too large");
+        if (u.cached && std::memcmp(u.value, &value, sizeof(T)) == 0)
+            return;
+        std::memcpy(u.value, &value, sizeof(T));
+        u.cached = true;
+        UniformTraits<T>::upload(u.location, value);
+    }
+    // same type check as uniform<T>(): a mismatch is reported and skipped
+    // instead of becoming a GL_INVALID_OPERATION
+    template <class T>
+    void setByName(const std::string &name, const T &value) const
+    {
+        int slot = findUniform(name);
+        if (slot < 0)
+            return;
+        UniformSlot &u = uniforms[slot];
+        if (!UniformTraits<T>::matches(u.type))
+        {
+            if (!u.mismatchReported)
+                std::cout << "ERROR::SHADER::UNIFORM_TYPE_MISMATCH: " << name << std::endl;
+            u.mismatchReported = true;
+            return;
+        }
+        store(u, value);
+    }
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(GLuint shader, std::string type)
@@ -6,7 +6,27 @@ Controls summary:
 - 4: Wrist bend + Wrist twist (mouse Y / X)
 - 5: Fingers (mouse Y / X)
 - SPACE: Toggle teapot follow (only if CanGrabTeapot() is true when not already following).
+- G: Move the palm next to the teapot (closed-form IK).
+- P: Print GL state, culling, LOD, texture and pass timing statistics.
 - ESC: Quit
+
+Pass timings (CPU and GPU ms per pass, averaged over 60 frames) show in the
+window title; RobotArm --timings FILE writes every window at exit
+(FILE ending in .json -> JSON, otherwise CSV). Also works with --headless.
+
+Static meshes are stored as 16-byte packed vertices (half position/uv,
+10-10-10-2 normal); --float-vertices keeps the 32-byte float layout, which
+is also used automatically when a model is beyond half precision.
+
+Headless (no window/GPU, EGL surfaceless, e.g. Mesa llvmpipe):
+  RobotArm --headless [--poses FILE] [--frames N] [--size WxH]
+                      [--png PREFIX | --raw FILE|-] [--ring N] [--timings FILE]
+                      [--float-vertices]
+  --poses: one pose per line, 9 joint values in ArmDof order
+           (BaseTransX BaseTransZ BaseSpin Shoulder Elbow Wrist WristTwist Finger1 Finger2);
+           without it the default pose is rendered --frames times.
+  --png:   PREFIX000000.png, ... (default "frame_")
+  --raw:   top-down RGB24 frames back to back ("-" = stdout)
 */
 
 #include <glad/glad.h>
@@ -20,7 +40,31 @@ Controls summary:
 #include <learnopengl/camera.h>
 #include <learnopengl/model.h>
 
+#include <robotarm/robot_arm.h>
+#include <robotarm/arm_ik.h>
+#include <robotarm/dls_ik.h>
+#include <robotarm/reach_map.h>
+#include <robotarm/grasp.h>
+
+#include <render/instance_batch.h>
+#include <render/geometry_pool.h>
+#include <render/culling.h>
+#include <render/lod.h>
+#include <render/pass_profiler.h>
+#include <render/frame_uniforms.h>
+#include <render/render_queue.h>
+#include <render/texture_loader.h>
+#include <render/texture_registry.h>
+#ifdef ROBOTARM_HEADLESS
+#include <render/headless.h>
+#include <render/frame_writer.h>
+#endif
+
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cstring>
 #include <cmath> // std::abs
 
 //#define STB_IMAGE_IMPLEMENTATION
@@ -37,19 +81,31 @@ float WristTwistAng = 10;
 float FingerAng1    = 45;  // 4
 float FingerAng2    = -90;
 
+// ArmDof 순서의 관절 변수 (체인 소스 / headless 포즈 입력)
+float* const ArmJointVars[ARM_DOF] = {
+	&BaseTransX, &BaseTransZ, &BaseSpin,
+	&ShoulderAng, &ElbowAng,
+	&WristAng, &WristTwistAng,
+	&FingerAng1, &FingerAng2
+};
+
+// 관절 테이블 + 링크 월드 변환 캐시 (매 프레임 한 번 계산)
+KinematicChain RobotChain;
+DLSIKSolver* PalmIK; // closed-form IK로 안 되는 목표용 (position-only)
+ReachMap ArmReach;   // robotarm_reachmap으로 미리 만든 도달 가능 영역 (없으면 사용 안 함)
+
 // === Extra credit state ===
 bool TeapotFollowWrist = false; // SPACE 토글 상태
 
-// ---- 잡기 판정 파라미터 (필요시 살짝 조정 가능) ----
-const float kGrabDist  = 0.35f; // palm-주전자 중심 거리 허용치 (모델 스케일 고려 여유있게)
-const float kMinClose1 = 10.0f; // FingerAng1 >= 10° 이면 '닫힘'
-const float kMinClose2 = 20.0f; // |FingerAng2| >= 20° 이면 '닫힘'
+// 잡기 판정 파라미터(kGrabDist, kMinClose1/2)는 robotarm/grasp.h
 
 // Forward declarations for helpers (used in processInput/myDisplay)
 glm::mat4 ComputePalmMatrix();
 inline glm::vec3 GetWorldPos(const glm::mat4& M);
 bool CanGrabTeapot();
 inline glm::mat4 TeapotLocalXform();
+glm::mat4 TeapotApproachPose();
+bool MovePalmTo(const glm::mat4& palmTarget);
 
 // ROBOT COLORS
 GLfloat Ground[] = { 0.5f, 0.5f, 0.5f };
@@ -65,6 +121,9 @@ int RobotControl = 0;
 // settings
 const unsigned int SCR_WIDTH = 768;
 const unsigned int SCR_HEIGHT = 768;
+// 현재 프레임버퍼 크기 (framebuffer_size_callback에서 갱신, 최소화로 0이 되면 이전 값 유지)
+int FramebufferWidth = SCR_WIDTH;
+int FramebufferHeight = SCR_HEIGHT;
 
 // camera
 //Camera camera(glm::vec3(0.0f, 0.8f, 1.2f), glm::vec3(0.0f, 0.5f, 0.0f), -90.f, 0.0f);
@@ -83,6 +142,46 @@ glm::vec3 lightColor = glm::vec3(1.0f, 1.0f, 1.0f);
 // shader
 Shader* PhongShader;
 Shader* FloorShader;
+Shader* PartShader;  // 로봇 부품 인스턴싱용 (instanced_phong)
+
+// 카메라/조명은 모든 셰이더가 공유하는 uniform block (FrameData, LightData)
+FrameUniforms SceneBlocks;
+
+// 물체별 uniform 핸들 (setupShader에서 한 번 찾아 둠, 셰이더에 없으면 무시됨)
+ObjectUniforms PhongU, FloorU, PartU;
+
+// Draw* 함수는 명령만 기록, 프레임 끝에 상태별로 정렬해서 한 번에 제출
+RenderQueue FrameQueue;
+GLStateCache GLState;
+
+// 정적 메시 전부 (기본 도형 + 주전자)가 VBO/EBO/VAO 하나를 나눠 씀
+GeometryPool SceneGeometry;
+// 기본은 16바이트 packed 정점 (half 위치/UV, 10-10-10-2 법선), --float-vertices면 32바이트 float
+bool PackedVertices = true;
+// 프레임의 모든 인스턴스 (바닥, 로봇 부품, 주전자): draw마다 baseInstance로 구간 지정
+InstanceBuffer SceneInstances;
+
+// 카메라 프러스텀 (updateFrameUniforms에서 갱신), 밖에 있는 물체는 명령을 만들지 않음
+FrustumCuller SceneCuller;
+
+// 화면에 투영된 크기로 부품마다 LOD 선택 (updateFrameUniforms에서 갱신)
+LodSelector SceneLod;
+LodStats PartLodStats;
+
+// 패스별 CPU/GPU 시간 (RenderQueue가 pass 단위로 측정), --timings 파일로 종료 시 저장
+enum ScenePass { PASS_GROUND, PASS_ARM, PASS_TEAPOT };
+PassProfiler Passes;
+std::string TimingsPath;
+
+// 프레임마다 모은 로봇 부품: 메시 종류 x LOD 단계별로 한 번씩만 그림
+LodInstanceBatch CylinderParts;
+LodInstanceBatch SphereParts;
+LodInstanceBatch ConeParts;
+
+// 텍스처 디코딩은 워커 스레드, 업로드는 GL 스레드 (createGLPrimitives 끝에서 Finish)
+// 모든 텍스처는 SceneTextures로 받음: 같은 파일은 한 번만, 마지막 사용자가 반환하면 삭제
+TextureLoader Textures;
+TextureRegistry SceneTextures;
 
 // ObjectModel
 Model* ourObjectModel;
@@ -98,7 +197,14 @@ static bool prevFollow = false;  // 이전 프레임의 팔로우 상태
 
 // HOUSE KEEPING
 void initGL(GLFWwindow** window);
+void setupRobotChain();
 void setupShader();
+void updateFrameUniforms(int width, int height);
+void printRenderStats();
+void finishTimings();
+#ifdef ROBOTARM_HEADLESS
+int runHeadless(int argc, char** argv);
+#endif
 void destroyShader();
 void createGLPrimitives();
 void destroyGLPrimitives();
@@ -117,6 +223,7 @@ void DrawArmSegment(glm::mat4 model);
 void DrawWrist(glm::mat4 model);
 void DrawFingerBase(glm::mat4 model);
 void DrawFingerTip(glm::mat4 model);
+void DrawRobotParts();
 
 void DrawObject(glm::mat4 model);
 bool hasTextures = false; 
@@ -126,63 +233,38 @@ void myDisplay()
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+	FrameQueue.Begin();
+	SceneInstances.Clear();
+	Passes.BeginFrame();
+
 	// Ground
 	glm::mat4 model = glm::mat4(1.0f);
 	DrawGroundPlane(model);
 
 	// === ROBOT DRAW CALLS ===
-	glm::mat4 R = glm::mat4(1.0f);
-
-	// 로봇 베이스 위치/회전(마우스로 제어하는 값 반영)
-	R = glm::translate(R, glm::vec3(BaseTransX, 0.0f, BaseTransZ));
-	R = glm::rotate(R, glm::radians(BaseSpin), glm::vec3(0.0f, 1.0f, 0.0f));
-
-	// 베이스
-	DrawBase(R);
-
-	// 어깨
-	glm::mat4 shoulder = R;
-	shoulder = glm::translate(shoulder, glm::vec3(0.0f, 0.40f, 0.0f));
-	shoulder = glm::rotate(shoulder, glm::radians(ShoulderAng), glm::vec3(0.0f, 0.0f, 1.0f));
-	DrawArmSegment(shoulder);
-
-	// 팔꿈치
-	glm::mat4 elbow = shoulder;
-	elbow = glm::translate(elbow, glm::vec3(0.0f, 0.50f, 0.0f));
-	elbow = glm::rotate(elbow, glm::radians(ElbowAng), glm::vec3(0.0f, 0.0f, 1.0f));
-	DrawArmSegment(elbow);
-
-	// 손목
-	glm::mat4 wrist = elbow;
-	wrist = glm::translate(wrist, glm::vec3(0.0f, 0.50f, 0.0f));
-	wrist = glm::rotate(wrist, glm::radians(WristAng), glm::vec3(0.0f, 0.0f, 1.0f));
-	wrist = glm::rotate(wrist, glm::radians(WristTwistAng), glm::vec3(0.0f, 1.0f, 0.0f));
-	DrawWrist(wrist);
-
-	// 손바닥(palm): wrist 기준 Y +0.2
-	glm::mat4 palm = wrist;
-	palm = glm::translate(palm, glm::vec3(0.0f, 0.10f, 0.0f));
+	// 체인은 프레임당 한 번만 계산하고, 그리기/잡기 판정 모두 같은 캐시를 사용
+	// (바뀐 관절 아래 링크만 다시 계산, 입력이 없는 프레임은 FK 없음)
+	UpdateRobotArmChain(RobotChain);
+
+	// Draw* 함수는 인스턴스만 추가하고, DrawRobotParts()에서 메시당 draw call 1번
+	CylinderParts.Clear();
+	SphereParts.Clear();
+	ConeParts.Clear();
+
+	DrawBase(RobotChain.World(LINK_BASE));
+	DrawArmSegment(RobotChain.World(LINK_SHOULDER));
+	DrawArmSegment(RobotChain.World(LINK_ELBOW));
+	DrawWrist(RobotChain.World(LINK_WRIST));
 
 	// 손가락 2개 (palm 기준 좌우로만 오프셋)
-	glm::mat4 f1 = palm;
-	f1 = glm::translate(f1, glm::vec3(+0.06f, 0.0f, 0.0f));
-	f1 = glm::rotate(f1, glm::radians(FingerAng1), glm::vec3(0.0f, 0.0f, 1.0f));
-	DrawFingerBase(f1);
-
-	glm::mat4 f1tip = f1;
-	f1tip = glm::translate(f1tip, glm::vec3(0.0f, 0.35f, 0.0f));
-	f1tip = glm::rotate(f1tip, glm::radians(FingerAng2), glm::vec3(0.0f, 0.0f, 1.0f));
-	DrawFingerTip(f1tip);
-
-	glm::mat4 f2 = palm;
-	f2 = glm::translate(f2, glm::vec3(-0.06f, 0.0f, 0.0f));
-	f2 = glm::rotate(f2, glm::radians(-FingerAng1), glm::vec3(0.0f, 0.0f, 1.0f));
-	DrawFingerBase(f2);
-
-	glm::mat4 f2tip = f2;
-	f2tip = glm::translate(f2tip, glm::vec3(0.0f, 0.35f, 0.0f));
-	f2tip = glm::rotate(f2tip, glm::radians(-FingerAng2), glm::vec3(0.0f, 0.0f, 1.0f));
-	DrawFingerTip(f2tip);
+	DrawFingerBase(RobotChain.World(LINK_FINGER1));
+	DrawFingerTip(RobotChain.World(LINK_FINGER1_TIP));
+	DrawFingerBase(RobotChain.World(LINK_FINGER2));
+	DrawFingerTip(RobotChain.World(LINK_FINGER2_TIP));
+
+	DrawRobotParts();
+
+	const glm::mat4& palm = RobotChain.World(LINK_PALM);
 
 	// === Teapot draw (Extra credit) ===
 	// SPACE 토글: 단, processInput에서 CanGrabTeapot() 만족할 때만 TeapotFollowWrist 가 true가 됨.
@@ -202,17 +284,38 @@ void myDisplay()
 		DrawObject(objectXform); // 바닥 위 기본 주전자 지금 위치기준으로 떨기기 
 	}
     prevFollow = TeapotFollowWrist;
+
+	// program -> VAO -> texture -> material 순으로 정렬 후 제출 (이미 바인딩된 상태는 생략)
+	// 같은 상태의 명령은 glMultiDrawElementsIndirect 한 번으로 묶임
+	SceneInstances.Upload();
+	FrameQueue.Flush(GLState);
+	Passes.EndFrame();
 }
 
 // ======================================================================
 // Main / Setup
 // ======================================================================
 
-int main()
+int main(int argc, char** argv)
 {
+#ifdef ROBOTARM_HEADLESS
+	for (int i = 1; i < argc; ++i)
+		if (std::strcmp(argv[i], "--headless") == 0)
+			return runHeadless(argc, argv);
+#endif
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (i + 1 < argc && std::strcmp(argv[i], "--timings") == 0)
+			TimingsPath = argv[i + 1];
+		else if (std::strcmp(argv[i], "--float-vertices") == 0)
+			PackedVertices = false;
+	}
+
 	GLFWwindow* window = NULL;
 
 	initGL(&window);
+	setupRobotChain();
 	setupShader();
 	createGLPrimitives();
 
@@ -227,28 +330,30 @@ int main()
 		lastFrame = currentFrame;
 
 		// view/projection transformations
-		PhongShader->use();
-		PhongShader->setMat4("projection", glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f));
-		PhongShader->setMat4("view", camera.GetViewMatrix());
-		PhongShader->setVec3("viewPos", camera.Position);
-		PhongShader->setVec3("lightPos", camera.Position);
-
-		FloorShader->use();
-		FloorShader->setMat4("projection", glm::perspective(glm::radians(camera.Zoom), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f));
-		FloorShader->setMat4("view", camera.GetViewMatrix());
-		FloorShader->setVec3("viewPos", camera.Position);
-		FloorShader->setVec3("lightPos", camera.Position);
+		updateFrameUniforms(FramebufferWidth, FramebufferHeight);
 
 		// render
 		myDisplay();
 
+		// 평균 구간이 끝날 때마다 창 제목에 패스별 시간 표시
+		static long shownWindows = 0;
+		if (Passes.Windows() != shownWindows)
+		{
+			shownWindows = Passes.Windows();
+			glfwSetWindowTitle(window, ("The Robot Arm | " + Passes.Summary()).c_str());
+		}
+
 		// glfw: swap buffers and poll IO events (keys pressed/released, mouse moved etc.)
 		glfwSwapBuffers(window);
 		glfwPollEvents();
 	}
 
+	finishTimings();
+	printRenderStats();
+
 	destroyGLPrimitives();
 	destroyShader();
+	delete PalmIK;
 
 	glfwDestroyWindow(window);
 	glfwTerminate();
@@ -256,10 +361,196 @@ int main()
 	return 0;
 }
 
+void printRenderStats()
+{
+	GLState.stats.Print(std::cout);
+	SceneCuller.stats.Print(std::cout);
+	PartLodStats.Print(std::cout);
+	SceneTextures.stats.Print(std::cout, SceneTextures.Resident());
+	Passes.Print(std::cout);
+}
+
+void finishTimings()
+{
+	Passes.Finish();
+	if (!TimingsPath.empty() && Passes.Dump(TimingsPath))
+		std::cout << "Pass timings written to " << TimingsPath << std::endl;
+}
+
+void updateFrameUniforms(int width, int height)
+{
+	float aspect = (float)width / (float)height;
+	// FrameData 블록 하나만 갱신 (카메라가 그대로면 업로드 없음)
+	// projection은 zoom/화면비가 바뀔 때만 다시 계산
+	static glm::mat4 projection(1.0f);
+	static float projectionZoom = -1.0f, projectionAspect = -1.0f;
+	if (camera.Zoom != projectionZoom || aspect != projectionAspect)
+	{
+		projection = glm::perspective(glm::radians(camera.Zoom), aspect, 0.1f, 100.0f);
+		projectionZoom = camera.Zoom;
+		projectionAspect = aspect;
+	}
+	FrameData frame;
+	frame.projection = projection;
+	frame.view = camera.GetViewMatrix();
+	frame.viewPos = camera.Position;
+	frame.lightPos = camera.Position;
+	SceneBlocks.SetFrame(frame);
+	SceneCuller.SetViewProjection(projection * frame.view);
+	SceneLod.SetView(camera.Position, projection, height);
+}
+
+#ifdef ROBOTARM_HEADLESS
+// ======================================================================
+// Headless batch rendering (--headless)
+// ======================================================================
+
+// 다음 포즈 한 줄 (빈 줄/# 주석 건너뜀), 값이 9개 미만이면 오류
+bool readPose(std::istream& in, long& lineNo, bool& ok)
+{
+	std::string line;
+	while (std::getline(in, line))
+	{
+		++lineNo;
+		size_t hash = line.find('#');
+		if (hash != std::string::npos) line.resize(hash);
+		std::istringstream ss(line);
+		float v[ARM_DOF];
+		int n = 0;
+		while (n < ARM_DOF && ss >> v[n]) ++n;
+		if (n == 0 && ss.eof()) continue;
+		if (n < ARM_DOF)
+		{
+			std::cout << "Headless: pose line " << lineNo << " needs " << ARM_DOF << " values" << std::endl;
+			ok = false;
+			return false;
+		}
+		for (int i = 0; i < ARM_DOF; ++i)
+			*ArmJointVars[i] = v[i];
+		return true;
+	}
+	return false;
+}
+
+int runHeadless(int argc, char** argv)
+{
+	const char* posesPath = nullptr;
+	long frames = 1;
+	int width = SCR_WIDTH, height = SCR_HEIGHT, ring = 3;
+	FrameWriter::Format format = FrameWriter::PNG;
+	std::string target = "frame_";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* a = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(a, "--headless") == 0) continue;
+		else if (std::strcmp(a, "--poses") == 0 && hasValue) posesPath = argv[++i];
+		else if (std::strcmp(a, "--frames") == 0 && hasValue) frames = std::atol(argv[++i]);
+		else if (std::strcmp(a, "--ring") == 0 && hasValue) ring = std::atoi(argv[++i]);
+		else if (std::strcmp(a, "--timings") == 0 && hasValue) TimingsPath = argv[++i];
+		else if (std::strcmp(a, "--float-vertices") == 0) PackedVertices = false;
+		else if (std::strcmp(a, "--png") == 0 && hasValue) { format = FrameWriter::PNG; target = argv[++i]; }
+		else if (std::strcmp(a, "--raw") == 0 && hasValue) { format = FrameWriter::RAW; target = argv[++i]; }
+		else if (std::strcmp(a, "--size") == 0 && hasValue)
+		{
+			if (std::sscanf(argv[++i], "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+			{
+				std::cout << "Headless: --size expects WxH" << std::endl;
+				return 1;
+			}
+		}
+		else
+		{
+			std::cout << "Headless: unknown option " << a << std::endl;
+			return 1;
+		}
+	}
+
+	// raw 프레임이 stdout으로 나가면 로그는 stderr로
+	std::streambuf* coutBuf = std::cout.rdbuf();
+	if (format == FrameWriter::RAW && target == "-")
+		std::cout.rdbuf(std::cerr.rdbuf());
+
+	std::ifstream poses;
+	if (posesPath)
+	{
+		poses.open(posesPath);
+		if (!poses)
+		{
+			std::cout << "Headless: cannot open " << posesPath << std::endl;
+			std::cout.rdbuf(coutBuf);
+			return 1;
+		}
+	}
+
+	HeadlessContext context;
+	// multi-draw indirect는 4.3, 안 되면 3.3 (RenderQueue가 draw 하나씩으로 대체)
+	bool contextOk = context.Create(4, 3) || context.Create(3, 3);
+	if (!contextOk || !gladLoadGLLoader((GLADloadproc)HeadlessContext::GetProcAddress))
+	{
+		std::cout << "Headless: no OpenGL 3.3 context" << std::endl;
+		std::cout.rdbuf(coutBuf);
+		return 1;
+	}
+
+	int status = 0;
+	{
+		setupRobotChain();
+		setupShader();
+		createGLPrimitives();
+		glEnable(GL_DEPTH_TEST);
+
+		OffscreenTarget offscreen;
+		PixelReadback readback;
+		FrameWriter writer;
+		if (!offscreen.Create(width, height) || !readback.Create(width, height, ring) || !writer.Open(format, target))
+			status = 1;
+
+		auto start = std::chrono::steady_clock::now();
+		long frame = 0, lineNo = 0;
+		bool posesOk = true;
+		while (status == 0)
+		{
+			if (posesPath ? !readPose(poses, lineNo, posesOk) : frame >= frames)
+				break;
+
+			offscreen.Bind();
+			updateFrameUniforms(width, height);
+			myDisplay();
+			if (!readback.Queue(frame, writer))
+				status = 1;
+			++frame;
+		}
+		if (!readback.Finish(writer) || !posesOk)
+			status = 1;
+		writer.Close();
+
+		double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Headless: " << writer.Frames() << " frames " << width << "x" << height
+			<< " in " << sec << " s (" << (sec > 0.0 ? writer.Frames() / sec : 0.0) << " frames/s, "
+			<< readback.Stalls() << " readback stalls)" << std::endl;
+		finishTimings();
+		printRenderStats();
+
+		readback.Destroy();
+		offscreen.Destroy();
+		destroyGLPrimitives();
+		destroyShader();
+		delete PalmIK;
+	}
+
+	context.Destroy();
+	std::cout.rdbuf(coutBuf);
+	return status;
+}
+#endif
+
 void initGL(GLFWwindow** window)
 {
 	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	// multi-draw indirect는 4.3, 안 되면 3.3 (RenderQueue가 draw 하나씩으로 대체)
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
@@ -268,7 +559,13 @@ void initGL(GLFWwindow** window)
 #endif
 
 	* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "The Robot Arm", NULL, NULL);
-	if (window == NULL)
+	if (*window == NULL)
+	{
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, "The Robot Arm", NULL, NULL);
+	}
+	if (*window == NULL)
 	{
 		std::cout << "Failed to create GLFW window" << std::endl;
 		glfwTerminate();
@@ -276,6 +573,8 @@ void initGL(GLFWwindow** window)
 	}
 	glfwMakeContextCurrent(*window);
 	glfwSetFramebufferSizeCallback(*window, framebuffer_size_callback);
+	// HiDPI에서는 창 크기와 프레임버퍼 크기가 다름
+	glfwGetFramebufferSize(*window, &FramebufferWidth, &FramebufferHeight);
 	glfwSetCursorPosCallback(*window, mouse_callback);
 	glfwSetMouseButtonCallback(*window, mouse_button_callback);
 	glfwSetKeyCallback(*window, processInput);
@@ -287,27 +586,62 @@ void initGL(GLFWwindow** window)
 	}
 }
 
+void setupRobotChain()
+{
+	const float* sources[ARM_DOF];
+	for (int i = 0; i < ARM_DOF; ++i)
+		sources[i] = ArmJointVars[i];
+	BuildRobotArmChain(RobotChain, sources);
+	UpdateRobotArmChain(RobotChain);
+
+	// base 위치는 고정, 회전 관절 5개만 풂
+	float* ikDofs[IK_DOF] = { &BaseSpin, &ShoulderAng, &ElbowAng, &WristAng, &WristTwistAng };
+	ArmJointLimits limits = DefaultArmJointLimits();
+	PalmIK = new DLSIKSolver(RobotChain, LINK_PALM, ikDofs, IK_DOF,
+		limits.lo + DOF_BASE_SPIN, limits.hi + DOF_BASE_SPIN);
+
+	if (!ArmReach.Open("robot_arm.reach"))
+		std::cout << "Reach map not loaded (run robotarm_reachmap to build robot_arm.reach)" << std::endl;
+}
+
 void setupShader()
 {
+    // 블록 binding 등록이 셰이더 링크보다 먼저
+    SceneBlocks.Create();
+
+    LightData light;
+    light.lightColor = lightColor;
+    light.ambientStrength = 0.1f;
+    light.specularStrength = 0.5f;
+    light.shininess = 32.0f;
+    SceneBlocks.SetLight(light);
+
     PhongShader = new Shader(
         "src/shaders/model_loading.vert",
         "src/shaders/model_loading.frag"
     );
-    PhongShader->use();
-    PhongShader->setVec3("lightColor", lightColor);
 
     FloorShader = new Shader(
         "src/shaders/phong.vert",
         "src/shaders/phong.frag"
     );
-    FloorShader->use();
-    FloorShader->setVec3("lightColor", lightColor);
+
+    PartShader = new Shader(
+        "src/shaders/instanced_phong.vert",
+        "src/shaders/instanced_phong.frag"
+    );
+
+    PhongU = ResolveObjectUniforms(*PhongShader);
+    FloorU = ResolveObjectUniforms(*FloorShader);
+    PartU = ResolveObjectUniforms(*PartShader);
 }
 
 void destroyShader()
 {
 	delete PhongShader;
 	delete FloorShader;
+	delete PartShader;
+	SceneBlocks.Destroy();
 }
 
 // ======================================================================
@@ -340,6 +674,16 @@ void processInput(GLFWwindow* window, int key, int scancode, int action, int mod
 			// FingerAng1 = 20.0f; FingerAng2 = -40.0f;
 		}
 	}
+	else if (key == GLFW_KEY_G && action == GLFW_PRESS)
+	{
+		// 들고 있지 않을 때만: 주전자 옆으로 palm 이동
+		if (!TeapotFollowWrist)
+			MovePalmTo(TeapotApproachPose());
+	}
+	else if (key == GLFW_KEY_P && action == GLFW_PRESS)
+	{
+		printRenderStats();
+	}
 	else if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
 	{
 		glfwSetWindowShouldClose(window, true);
@@ -349,6 +693,11 @@ void processInput(GLFWwindow* window, int key, int scancode, int action, int mod
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	glViewport(0, 0, width, height);
+	if (width > 0 && height > 0)
+	{
+		FramebufferWidth = width;
+		FramebufferHeight = height;
+	}
 }
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos)
@@ -397,51 +746,57 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
 
 class Primitive {
 public:
-	Primitive() {
-		glGenVertexArrays(1, &VAO);
-		glGenBuffers(1, &vbo);
-		glGenBuffers(1, &ebo);
-	}
-	~Primitive() {
-		if (!ebo) glDeleteBuffers(1, &ebo);
-		if (!vbo) glDeleteBuffers(1, &vbo);
-		if (!VAO) glDeleteVertexArrays(1, &VAO);
-	}
-	void Draw() {
-		glBindVertexArray(VAO);
-		glDrawElements(GL_TRIANGLE_STRIP, IndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+	virtual ~Primitive() {}
+	// 이 메시(LOD 단계)를 그리는 명령 (셰이더/인스턴스는 호출하는 쪽에서 채움)
+	virtual RenderCommand Command(int lod = 0) const {
+		const MeshRange& range = Range(lod);
+		RenderCommand c;
+		c.vao = SceneGeometry.VAO();
+		c.mode = range.mode;
+		c.count = range.count;
+		c.indexType = range.indexType;
+		c.firstIndex = range.firstIndex;
+		c.baseVertex = range.baseVertex;
+		return c;
 	}
+	const MeshRange& Range(int lod) const { return Lods[lod < LodLevels ? lod : LodLevels - 1]; }
+	const Bounds& LocalBounds() const { return LocalBox; }
+	int Levels() const { return LodLevels; }
 
 protected:
-	unsigned int VAO = 0, vbo = 0, ebo = 0;
-	unsigned int IndexCount = 0;
+	MeshRange Lods[LOD_LEVELS];   // SceneGeometry 안의 위치, 거친 것부터
+	int LodLevels = 1;
+	Bounds LocalBox;   // 생성 시 계산한 AABB + 구
 	float height = 1.0f;
     float radius[2] = { 1.0f, 1.0f };
 };
 
+// Cylinder/Sphere는 LodSegments의 단계마다 한 벌씩 만듦
 class Cylinder : public Primitive {
 public:
-	Cylinder(float bottomRadius = 0.5f, float topRadius = 0.5f, int NumSegs = 16);
+	Cylinder(float bottomRadius = 0.5f, float topRadius = 0.5f);
+private:
+	MeshRange Build(int NumSegs);
 };
 
 class Sphere : public Primitive {
 public:
-	Sphere(int NumSegs = 16);
+	Sphere();
+private:
+	MeshRange Build(int NumSegs);
 };
 
 class Plane : public Primitive {
 public:
 	Plane();
-	void Draw() {
-		glBindVertexArray(VAO);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, floorTexture);
-		glDrawElements(GL_TRIANGLE_STRIP, IndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+	~Plane() { SceneTextures.Release(floorTexture); }
+	RenderCommand Command(int lod = 0) const override {
+		RenderCommand c = Primitive::Command(lod);
+		c.texture = floorTexture;
+		return c;
 	}
 private:
-	unsigned int floorTexture;
+	unsigned int floorTexture = 0;
 };
 
 Sphere* unitSphere;
@@ -451,14 +806,45 @@ Cylinder* unitCone;
 
 void createGLPrimitives()
 {
+	Textures.Start();
+	SceneTextures.SetLoader(&Textures);
+
 	unitSphere = new Sphere();
 	groundPlane = new Plane();
 	unitCylinder = new Cylinder();
 	unitCone = new Cylinder(0.5f, 0.0f);
 
-	// Load Object Model
-	ourObjectModel = new Model(ourObjectPath);
+	// Load Object Model (메시는 SceneGeometry로)
+	ourObjectModel = new Model(ourObjectPath, false, &SceneGeometry, &SceneTextures);
 	hasTextures = (ourObjectModel->textures_loaded.size() == 0) ? 0 : 1;
+
+	// 모든 정적 메시를 한 번에 올리고, 인스턴스 버퍼를 공용 VAO에 연결
+	SceneGeometry.SetVertexFormat(PackedVertices ? POOL_VERTEX_PACKED : POOL_VERTEX_FLOAT);
+	SceneGeometry.Upload();
+	std::cout << "Geometry: " << SceneGeometry.VertexCount() << " vertices, " << SceneGeometry.VertexBytes() / 1024 << " KB ("
+		<< (SceneGeometry.VertexFormat() == POOL_VERTEX_PACKED ? "packed" : "float") << "), indices " << SceneGeometry.IndexBytes() / 1024 << " KB" << std::endl;
+	SceneInstances.Create();
+	glBindVertexArray(SceneGeometry.VAO());
+	SceneInstances.BindAttributes();
+	glBindVertexArray(0);
+	FrameQueue.SetInstanceSource(&SceneInstances);
+
+	// 메시를 만드는 동안 디코딩된 텍스처를 마저 올리고 워커 정리
+	Textures.Finish();
+	Textures.Stop();
+	SceneTextures.SetLoader(nullptr);
+	GLState.Forget(GL_STATE_VAO | GL_STATE_TEXTURES);
+
+	// ScenePass 순서대로 등록
+	Passes.AddPass("ground");
+	Passes.AddPass("arm");
+	Passes.AddPass("teapot");
+	Passes.Create(60);
+	FrameQueue.SetProfiler(&Passes);
+
+	CylinderParts.Setup(&SceneCuller, &SceneLod, unitCylinder->LocalBounds(), unitCylinder->Levels());
+	SphereParts.Setup(&SceneCuller, &SceneLod, unitSphere->LocalBounds(), unitSphere->Levels());
+	ConeParts.Setup(&SceneCuller, &SceneLod, unitCone->LocalBounds(), unitCone->Levels());
 }
 void destroyGLPrimitives()
 {
@@ -468,13 +854,24 @@ void destroyGLPrimitives()
 	delete unitCone;
 
 	delete ourObjectModel;
+
+	FrameQueue.SetProfiler(nullptr);
+	Passes.Destroy();
+	FrameQueue.Destroy();
+	SceneInstances.Destroy();
+	SceneGeometry.Destroy();
 }
 
 void DrawGroundPlane(glm::mat4 model)
 {
-	FloorShader->use();
-	FloorShader->setMat4("model", model);
-	groundPlane->Draw();
+	if (!SceneCuller.Visible(groundPlane->LocalBounds(), model)) return;
+
+	RenderCommand c = groundPlane->Command();
+	c.shader = FloorShader;
+	c.pass = PASS_GROUND;
+	c.instances = 1;
+	c.baseInstance = SceneInstances.Append(model, glm::vec3(Ground[0], Ground[1], Ground[2]));
+	FrameQueue.Submit(c);
 }
 
 void DrawJoint(glm::mat4 model)
@@ -482,36 +879,25 @@ void DrawJoint(glm::mat4 model)
 	glm::mat4 Mat1 = glm::scale(glm::mat4(1.0f), glm::vec3(0.15f, 0.15f, 0.12f));
 	Mat1 = glm::rotate(Mat1, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
 
-	PhongShader->use();
 	Mat1 = model * Mat1;
-	PhongShader->setMat4("model", Mat1);
-	PhongShader->setVec3("ObjColor", glm::vec3(Joints[0], Joints[1], Joints[2]));
-	PhongShader->setInt("hasTextures", false);
-	unitCylinder->Draw();
+	CylinderParts.Add(Mat1, glm::vec3(Joints[0], Joints[1], Joints[2]));
 }
 void DrawBase(glm::mat4 model)
 {
 	glm::mat4 Base = glm::scale(glm::mat4(1.0f), glm::vec3(0.2f, 0.025f, 0.2f));
 	glm::mat4 InBase = glm::inverse(Base);
 
-	PhongShader->use();
 	Base = model * Base;
-	PhongShader->setMat4("model", Base);
-	PhongShader->setVec3("ObjColor", glm::vec3(Joints[0], Joints[1], Joints[2]));
-	PhongShader->setInt("hasTextures", false);
-	unitCylinder->Draw();
+	CylinderParts.Add(Base, glm::vec3(Joints[0], Joints[1], Joints[2]));
 
 	glm::mat4 Mat1 = glm::translate(InBase, glm::vec3(0.0f, 0.2f, 0.0f));
 	Mat1 = glm::scale(Mat1, glm::vec3(0.1f, 0.4f, 0.1f));
 
 	Mat1 = Base * Mat1;
-	PhongShader->setMat4("model", Mat1);
-	PhongShader->setVec3("ObjColor", glm::vec3(Arms[0], Arms[1], Arms[2]));
-	unitCylinder->Draw();
+	CylinderParts.Add(Mat1, glm::vec3(Arms[0], Arms[1], Arms[2]));
 
 	glm::mat4 Mat2 = glm::translate(InBase, glm::vec3(0.0f, 0.4f, 0.0f));
 	Mat2 = Base * Mat2;
-	PhongShader->setMat4("model", Mat2);
 	DrawJoint(Mat2);
 }
 void DrawArmSegment(glm::mat4 model)
@@ -520,16 +906,11 @@ void DrawArmSegment(glm::mat4 model)
 	Base = glm::scale(Base, glm::vec3(0.1f, 0.5f, 0.1f));
 	glm::mat4 InBase = glm::inverse(Base);
 
-	PhongShader->use();
 	Base = model * Base;
-	PhongShader->setMat4("model", Base);
-	PhongShader->setVec3("ObjColor", glm::vec3(Arms[0], Arms[1], Arms[2]));
-	PhongShader->setInt("hasTextures", false);
-	unitCylinder->Draw();
+	CylinderParts.Add(Base, glm::vec3(Arms[0], Arms[1], Arms[2]));
 
 	glm::mat4 Mat1 = glm::translate(InBase, glm::vec3(0.0f, 0.5f, 0.0f));;
 	Mat1 = Base * Mat1;
-	PhongShader->setMat4("model", Mat1);
 	DrawJoint(Mat1);
 }
 void DrawWrist(glm::mat4 model)
@@ -538,20 +919,14 @@ void DrawWrist(glm::mat4 model)
 	Base = glm::scale(Base, glm::vec3(0.08f, 0.2f, 0.08f));
 	glm::mat4 InBase = glm::inverse(Base);
 
-	PhongShader->use();
 	Base = model * Base;
-	PhongShader->setMat4("model", Base);
-	PhongShader->setVec3("ObjColor", glm::vec3(Fingers[0], Fingers[1], Fingers[2]));
-	PhongShader->setInt("hasTextures", false);
-	unitCylinder->Draw();
+	CylinderParts.Add(Base, glm::vec3(Fingers[0], Fingers[1], Fingers[2]));
 
 	glm::mat4 Mat1 = glm::translate(InBase, glm::vec3(0.0f, 0.2f, 0.0f));
 	Mat1 = glm::scale(Mat1, glm::vec3(0.06f, 0.06f, 0.06f));
 
 	Mat1 = Base * Mat1;
-	PhongShader->setMat4("model", Mat1);
-	PhongShader->setVec3("ObjColor", glm::vec3(FingerJoints[0], FingerJoints[1], FingerJoints[2]));
-	unitSphere->Draw(); 
+	SphereParts.Add(Mat1, glm::vec3(FingerJoints[0], FingerJoints[1], FingerJoints[2]));
 }
 void DrawFingerBase(glm::mat4 model)
 {
@@ -559,41 +934,79 @@ void DrawFingerBase(glm::mat4 model)
 	Base = glm::scale(Base, glm::vec3(0.05f, 0.3f, 0.05f));
 	glm::mat4 InBase = glm::inverse(Base);
 
-	PhongShader->use();
 	Base = model * Base;
-	PhongShader->setMat4("model", Base);
-	PhongShader->setVec3("ObjColor", glm::vec3(Fingers[0], Fingers[1], Fingers[2]));
-	PhongShader->setInt("hasTextures", false);
-	unitCylinder->Draw();
+	CylinderParts.Add(Base, glm::vec3(Fingers[0], Fingers[1], Fingers[2]));
 
 	glm::mat4 Mat1 = glm::translate(InBase, glm::vec3(0.0f, 0.35f, 0.0f));
 	Mat1 = glm::scale(Mat1, glm::vec3(0.05f, 0.05f, 0.05f));
 
 	Mat1 = Base * Mat1;
-	PhongShader->setMat4("model", Mat1);
-	PhongShader->setVec3("ObjColor", glm::vec3(FingerJoints[0], FingerJoints[1], FingerJoints[2]));
-	unitSphere->Draw();
+	SphereParts.Add(Mat1, glm::vec3(FingerJoints[0], FingerJoints[1], FingerJoints[2]));
 }
 void DrawFingerTip(glm::mat4 model)
 {
 	glm::mat4 Base = glm::scale(glm::mat4(1.0f), glm::vec3(0.05f, 0.25f, 0.05f));
 	Base = glm::translate(Base, glm::vec3(0.0f, 0.4f, 0.0f));
 
-	PhongShader->use();
 	Base = model * Base;
-	PhongShader->setMat4("model", Base);
-	PhongShader->setVec3("ObjColor", glm::vec3(Fingers[0], Fingers[1], Fingers[2]));
-	PhongShader->setInt("hasTextures", false);
-	unitCone->Draw();
+	ConeParts.Add(Base, glm::vec3(Fingers[0], Fingers[1], Fingers[2]));
+}
+
+// 모은 부품을 메시/LOD별로 인스턴스 버퍼에 붙이고 instanced draw 명령 (팔 개수와 무관)
+void SubmitParts(const Primitive* mesh, const LodInstanceBatch& parts)
+{
+	for (int lod = 0; lod < parts.Levels(); ++lod)
+	{
+		const InstanceBatch& level = parts.Level(lod);
+		if (level.Count() == 0) continue;
+		RenderCommand c = mesh->Command(lod);
+		c.shader = PartShader;
+		c.pass = PASS_ARM;
+		c.instances = level.Count();
+		c.baseInstance = SceneInstances.Append(level);
+		FrameQueue.Submit(c);
+		PartLodStats.Count(lod, level.Count(), mesh->Range(lod));
+	}
+}
+
+void DrawRobotParts()
+{
+	++PartLodStats.frames;
+	SubmitParts(unitCylinder, CylinderParts);
+	SubmitParts(unitSphere, SphereParts);
+	SubmitParts(unitCone, ConeParts);
 }
 
 void DrawObject(glm::mat4 model)
 {
-	PhongShader->use();
-	PhongShader->setMat4("model", model);
-	PhongShader->setVec3("ObjColor", glm::vec3(1.0f, 1.0f, 0.0f));
-	PhongShader->setInt("hasTextures", hasTextures);
-	ourObjectModel->Draw(*PhongShader);
+	// 메시마다 명령 하나, 인스턴스(변환/색)는 보이는 메시들이 공유
+	GLuint instance = 0;
+	int material = -1;
+	for (const PooledMesh& mesh : ourObjectModel->pooledMeshes)
+	{
+		if (!SceneCuller.Visible(mesh.bounds, model)) continue;
+		if (material < 0)
+		{
+			instance = SceneInstances.Append(model, glm::vec3(1.0f, 1.0f, 0.0f));
+			material = FrameQueue.AddMaterial(glm::vec3(1.0f, 1.0f, 0.0f), hasTextures);
+		}
+
+		RenderCommand c;
+		c.shader = PhongShader;
+		c.uniforms = &PhongU;
+		c.pass = PASS_TEAPOT;
+		c.vao = SceneGeometry.VAO();
+		c.texture = hasTextures ? mesh.diffuse : 0;
+		c.material = material;
+		c.mode = mesh.range.mode;
+		c.count = mesh.range.count;
+		c.indexType = mesh.range.indexType;
+		c.instances = 1;
+		c.firstIndex = mesh.range.firstIndex;
+		c.baseVertex = mesh.range.baseVertex;
+		c.baseInstance = instance;
+		FrameQueue.Submit(c);
+	}
 }
 
 // ======================================================================
@@ -602,27 +1015,8 @@ void DrawObject(glm::mat4 model)
 
 glm::mat4 ComputePalmMatrix()
 {
-	// myDisplay의 계층과 동일하게 구성해서 palm의 월드 변환을 계산
-	glm::mat4 R = glm::mat4(1.0f);
-	R = glm::translate(R, glm::vec3(BaseTransX, 0.0f, BaseTransZ));
-	R = glm::rotate(R, glm::radians(BaseSpin), glm::vec3(0.0f, 1.0f, 0.0f));
-
-	glm::mat4 shoulder = R;
-	shoulder = glm::translate(shoulder, glm::vec3(0.0f, 0.40f, 0.0f));
-	shoulder = glm::rotate(shoulder, glm::radians(ShoulderAng), glm::vec3(0.0f, 0.0f, 1.0f));
-
-	glm::mat4 elbow = shoulder;
-	elbow = glm::translate(elbow, glm::vec3(0.0f, 0.50f, 0.0f));
-	elbow = glm::rotate(elbow, glm::radians(ElbowAng), glm::vec3(0.0f, 0.0f, 1.0f));
-
-	glm::mat4 wrist = elbow;
-	wrist = glm::translate(wrist, glm::vec3(0.0f, 0.50f, 0.0f));
-	wrist = glm::rotate(wrist, glm::radians(WristAng), glm::vec3(0.0f, 0.0f, 1.0f));
-	wrist = glm::rotate(wrist, glm::radians(WristTwistAng), glm::vec3(0.0f, 1.0f, 0.0f));
-
-	glm::mat4 palm = wrist;
-	palm = glm::translate(palm, glm::vec3(0.0f, 0.2f, 0.0f));
-	return palm;
+	// myDisplay()와 같은 체인 캐시에서 palm의 월드 변환을 읽음 (바뀐 관절이 있으면 먼저 갱신)
+	return PalmMatrix(RobotChain);
 }
 
 inline glm::vec3 GetWorldPos(const glm::mat4& M)
@@ -640,30 +1034,97 @@ inline glm::mat4 TeapotLocalXform()
 	return T * R * S;
 }
 
+glm::mat4 TeapotApproachPose()
+{
+	// 베이스 쪽에서 수평으로 접근: palm Y축이 주전자를 향하고, 잡기 거리 안쪽에 위치
+	glm::vec3 teapotPos = GetWorldPos(objectXform);
+	glm::vec3 dir = teapotPos - glm::vec3(BaseTransX, teapotPos.y, BaseTransZ);
+	dir = (glm::length(dir) > 1e-4f) ? glm::normalize(dir) : glm::vec3(1.0f, 0.0f, 0.0f);
+
+	glm::vec3 Y = dir;
+	glm::vec3 X = glm::normalize(glm::cross(Y, glm::vec3(0.0f, 1.0f, 0.0f)));
+	glm::vec3 Z = glm::cross(X, Y);
+
+	glm::mat4 M(1.0f);
+	M[0] = glm::vec4(X, 0.0f);
+	M[1] = glm::vec4(Y, 0.0f);
+	M[2] = glm::vec4(Z, 0.0f);
+	M[3] = glm::vec4(teapotPos - dir * 0.25f + glm::vec3(0.0f, 0.15f, 0.0f), 1.0f);
+	return M;
+}
+
+bool MovePalmTo(const glm::mat4& palmTarget)
+{
+	IKResult ik = SolveArmIK(palmTarget, BaseTransX, BaseTransZ, DefaultArmJointLimits(), BaseSpin);
+	if (ik.status != IKStatus::Ok)
+	{
+		// closed-form 실패 시: 위치만이라도 최대한 가깝게 (DLS, 현재 자세에서 warm start)
+		std::cout << (ik.status == IKStatus::Unreachable ? "IK: target out of reach" : "IK: every solution violates a joint limit")
+			<< ", falling back to position-only DLS" << std::endl;
+
+		// reach map은 DLS 시작 자세로만 사용 (몬테카를로 샘플이라 빈 칸도 닿을 수 있음)
+		glm::vec3 local = glm::vec3(palmTarget[3]) - glm::vec3(BaseTransX, 0.0f, BaseTransZ);
+		const ReachCell* cell = ArmReach.IsOpen() ? ArmReach.Seed(local) : nullptr;
+
+		DLSIKResult r = PalmIK->Solve(palmTarget);
+		if (!r.converged && cell)
+		{
+			// 현재 자세에서 안 되면 그 근처에서 조작성이 가장 좋았던 자세로 다시 시작
+			float first[IK_DOF] = { BaseSpin, ShoulderAng, ElbowAng, WristAng, WristTwistAng };
+			BaseSpin      = cell->seed[IK_BASE_SPIN];
+			ShoulderAng   = cell->seed[IK_SHOULDER];
+			ElbowAng      = cell->seed[IK_ELBOW];
+			WristAng      = cell->seed[IK_WRIST];
+			WristTwistAng = cell->seed[IK_WRIST_TWIST];
+			DLSIKResult reseeded = PalmIK->Solve(palmTarget);
+			if (reseeded.converged || reseeded.positionError < r.positionError)
+				r = reseeded;
+			else
+			{
+				// 다시 풀어도 더 나빠졌으면 첫 번째 결과로 되돌림
+				BaseSpin      = first[IK_BASE_SPIN];
+				ShoulderAng   = first[IK_SHOULDER];
+				ElbowAng      = first[IK_ELBOW];
+				WristAng      = first[IK_WRIST];
+				WristTwistAng = first[IK_WRIST_TWIST];
+			}
+		}
+		return r.converged;
+	}
+
+	float current[IK_DOF] = { BaseSpin, ShoulderAng, ElbowAng, WristAng, WristTwistAng };
+	const IKSolution& sol = ik.solutions[SelectClosestIKSolution(ik, current)];
+	BaseSpin      = sol.joint[IK_BASE_SPIN];
+	ShoulderAng   = sol.joint[IK_SHOULDER];
+	ElbowAng      = sol.joint[IK_ELBOW];
+	WristAng      = sol.joint[IK_WRIST];
+	WristTwistAng = sol.joint[IK_WRIST_TWIST];
+	return true;
+}
+
 bool CanGrabTeapot()
 {
 	if (TeapotFollowWrist) return false; // 이미 들고 있으면 새로 잡기 X
 
-	// 1) 손가락이 충분히 '쥔' 상태인지 (완화 조건)
-	bool fingersClosed =
-		(FingerAng1 >= kMinClose1) && (std::abs(FingerAng2) >= kMinClose2);
-	if (!fingersClosed) return false;
-
-	// 2) 손바닥과 주전자 중심이 충분히 가까운지
-	glm::vec3 palmPos   = GetWorldPos(ComputePalmMatrix());
-	glm::vec3 teapotPos = GetWorldPos(objectXform); // teapot 모델 원점이 완전 중심이 아닐 수 있어 거리를 여유있게
-	float dist = glm::length(palmPos - teapotPos);
-	return dist <= kGrabDist;
+	// 손가락이 충분히 '쥔' 상태 + 손바닥과 주전자 중심이 충분히 가까운지
+	// (teapot 모델 원점이 완전 중심이 아닐 수 있어 거리를 여유있게)
+	return CanGrasp(RobotChain, FingerAng1, FingerAng2, GetWorldPos(objectXform));
 }
 
 // ======================================================================
 // Sphere / Plane / Cylinder implementations
 // ======================================================================
 
-Sphere::Sphere(int NumSegs)
+Sphere::Sphere()
 {
-	std::vector<glm::vec3> positions;
-	std::vector<glm::vec3> normals;
+	LodLevels = LOD_LEVELS;
+	for (int i = 0; i < LOD_LEVELS; ++i)
+		Lods[i] = Build(LodSegments[i]);
+}
+
+MeshRange Sphere::Build(int NumSegs)
+{
+	std::vector<PoolVertex> vertices;
 	std::vector<unsigned int> indices;
 
 	const unsigned int X_SEGMENTS = NumSegs;
@@ -680,142 +1141,62 @@ Sphere::Sphere(int NumSegs)
 			float yPos = std::cos(ySegment * PI);
 			float zPos = std::sin(xSegment * 2.0f * PI) * std::sin(ySegment * PI);
 
-			positions.push_back(glm::vec3(xPos, yPos, zPos));
-			normals.push_back(glm::vec3(xPos, yPos, zPos));
+			PoolVertex v;
+			v.position = glm::vec3(xPos, yPos, zPos);
+			v.normal = v.position;
+			v.uv = glm::vec2(xSegment, ySegment);
+			vertices.push_back(v);
 		}
 	}
 
-	bool oddRow = false;
+	// 위도 한 줄마다 strip 하나, 줄 사이는 primitive restart
 	for (unsigned int y = 0; y < Y_SEGMENTS; ++y)
 	{
-		if (!oddRow)
-		{
-			for (unsigned int x = 0; x <= X_SEGMENTS; ++x)
-			{
-				indices.push_back(y * (X_SEGMENTS + 1) + x);
-				indices.push_back((y + 1) * (X_SEGMENTS + 1) + x);
-			}
-		}
-		else
-		{
-			for (int x = X_SEGMENTS; x >= 0; --x)
-			{
-				indices.push_back((y + 1) * (X_SEGMENTS + 1) + x);
-				indices.push_back(y * (X_SEGMENTS + 1) + x);
-			}
-		}
-		oddRow = !oddRow;
-	}
-
-	IndexCount = (unsigned int)indices.size();
-
-	std::vector<float> data;
-	for (size_t i = 0; i < positions.size(); ++i)
-	{
-		data.push_back(positions[i].x);
-		data.push_back(positions[i].y);
-		data.push_back(positions[i].z);
-		if (normals.size() > 0)
+		if (y > 0)
+			indices.push_back(PrimitiveRestart);
+		for (unsigned int x = 0; x <= X_SEGMENTS; ++x)
 		{
-			data.push_back(normals[i].x);
-			data.push_back(normals[i].y);
-			data.push_back(normals[i].z);
+			indices.push_back(y * (X_SEGMENTS + 1) + x);
+			indices.push_back((y + 1) * (X_SEGMENTS + 1) + x);
 		}
 	}
-	
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-	GLsizei stride = (3 + 3) * sizeof(float);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-}
-
-unsigned int loadTexture(char const* path)
-{
-	unsigned int textureID;
-	glGenTextures(1, &textureID);
-
-	int width, height, nrComponents;
-	unsigned char* data = stbi_load(path, &width, &height, &nrComponents, 0);
-	if (data)
-	{
-		GLenum format = GL_RGB;
-		if (nrComponents == 1)
-			format = GL_RED;
-		else if (nrComponents == 3)
-			format = GL_RGB;
-		else if (nrComponents == 4)
-			format = GL_RGBA;
-
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, format == GL_RGBA ? GL_CLAMP_TO_EDGE : GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		stbi_image_free(data);
-	}
-	else
-	{
-		std::cout << "Texture failed to load at path: " << path << std::endl;
-		stbi_image_free(data);
-	}
 
-	return textureID;
+	LocalBox = ComputeBounds(vertices.data(), vertices.size());
+	return SceneGeometry.Add(vertices, indices, GL_TRIANGLE_STRIP);
 }
 
 Plane::Plane()
 {
-	float data[] = {
-		// positions           // normals          // texcoords
-		-10.0f, 0.0f, -10.0f,  0.0f, 1.0f,  0.0f,  0.0f,  0.0f,
-		 10.0f, 0.0f, -10.0f,  0.0f, 1.0f,  0.0f,  10.0f, 0.0f,
-		 10.0f, 0.0f,  10.0f,  0.0f, 1.0f,  0.0f,  10.0f, 10.0f,
-		-10.0f, 0.0f,  10.0f,  0.0f, 1.0f,  0.0f,  0.0f,  10.0f
+	PoolVertex data[] = {
+		//  positions                          normals                         texcoords
+		{ glm::vec3(-10.0f, 0.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(0.0f,  0.0f) },
+		{ glm::vec3( 10.0f, 0.0f, -10.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(10.0f, 0.0f) },
+		{ glm::vec3( 10.0f, 0.0f,  10.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(10.0f, 10.0f) },
+		{ glm::vec3(-10.0f, 0.0f,  10.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(0.0f,  10.0f) }
 	};
 	unsigned int indices[] = { 0, 1, 3, 2 };
 
-	IndexCount = sizeof(indices)/sizeof(unsigned int);
-
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(data), data, GL_STATIC_DRAW);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-	GLsizei stride = (3 + 3 + 2) * sizeof(float);
-
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	Lods[0] = SceneGeometry.Add(data, 4, indices, 4, GL_TRIANGLE_STRIP);
+	LocalBox = ComputeBounds(data, 4);
 
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-
-	glBindVertexArray(0);
-
-	unsigned int floorTexture = loadTexture("src/textures/wood.png");
+	floorTexture = SceneTextures.Acquire("src/textures/wood.png", TEXTURE_CLAMP_RGBA);
 	FloorShader->use();
 	FloorShader->setInt("texture1", 0);
 	glActiveTexture(GL_TEXTURE0);
 	glBindTexture(GL_TEXTURE_2D, floorTexture);
 }
 
-Cylinder::Cylinder(float bottomRadius, float topRadius, int NumSegs)
+Cylinder::Cylinder(float bottomRadius, float topRadius)
 {
 	radius[0] = bottomRadius; radius[1] = topRadius;
 
+	LodLevels = LOD_LEVELS;
+	for (int i = 0; i < LOD_LEVELS; ++i)
+		Lods[i] = Build(LodSegments[i]);
+}
+
+MeshRange Cylinder::Build(int NumSegs)
+{
 	std::vector<glm::vec3> base;
 	std::vector<glm::vec3> positions;
 	std::vector<glm::vec3> normals;
@@ -914,30 +1295,13 @@ Cylinder::Cylinder(float bottomRadius, float topRadius, int NumSegs)
 		}
 	}
 
-	IndexCount = (unsigned int)indices.size();
-
-	std::vector<float> data;
+	std::vector<PoolVertex> vertices(positions.size());
 	for (size_t i = 0; i < positions.size(); ++i)
 	{
-		data.push_back(positions[i].x);
-		data.push_back(positions[i].y);
-		data.push_back(positions[i].z);
-
-		if (normals.size() > 0)
-		{
-			data.push_back(normals[i].x);
-			data.push_back(normals[i].y);
-			data.push_back(normals[i].z);
-		}
+		vertices[i].position = positions[i];
+		vertices[i].normal = normals[i];
+		vertices[i].uv = glm::vec2(0.0f);
 	}
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(float), &data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
-	GLsizei stride = (3 + 3) * sizeof(float);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+	LocalBox = ComputeBounds(vertices.data(), vertices.size());
+	return SceneGeometry.Add(vertices, indices, GL_TRIANGLES);   // 삼각형 리스트
 }
@@ -0,0 +1,109 @@
+#include <render/culling.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULLING_SSE2 1
+#endif
+
+Bounds ComputeBounds(const PoolVertex* vertices, size_t count)
+{
+    Bounds b;
+    if (count == 0) return b;
+
+    glm::vec3 lo = vertices[0].position, hi = lo;
+    for (size_t i = 1; i < count; ++i)
+    {
+        lo = glm::min(lo, vertices[i].position);
+        hi = glm::max(hi, vertices[i].position);
+    }
+    b.center = (lo + hi) * 0.5f;
+    b.extent = (hi - lo) * 0.5f;
+
+    float r2 = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        glm::vec3 d = vertices[i].position - b.center;
+        r2 = std::max(r2, glm::dot(d, d));
+    }
+    b.radius = std::sqrt(r2);
+    return b;
+}
+
+FrustumCuller::FrustumCuller()
+{
+    // six planes plus two always-pass pads (everything passes before SetViewProjection)
+    for (int i = 0; i < 8; ++i)
+    {
+        nx[i] = ny[i] = nz[i] = 0.0f;
+        nw[i] = FLT_MAX;
+    }
+}
+
+void FrustumCuller::SetViewProjection(const glm::mat4& clip)
+{
+    // Gribb/Hartmann: row3 +- row0/1/2 (glm is column-major, row i = m[c][i])
+    for (int p = 0; p < 6; ++p)
+    {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        glm::vec4 plane(clip[0][3] + sign * clip[0][row],
+                        clip[1][3] + sign * clip[1][row],
+                        clip[2][3] + sign * clip[2][row],
+                        clip[3][3] + sign * clip[3][row]);
+        float len = glm::length(glm::vec3(plane));
+        if (len > 0.0f) plane /= len;
+        nx[p] = plane.x;
+        ny[p] = plane.y;
+        nz[p] = plane.z;
+        nw[p] = plane.w;
+    }
+}
+
+bool FrustumCuller::Visible(const Bounds& local, const glm::mat4& world)
+{
+    ++stats.tested;
+
+    // world AABB (Arvo) and sphere; the scale bound keeps the sphere conservative
+    glm::vec3 c = glm::vec3(world * glm::vec4(local.center, 1.0f));
+    glm::mat3 m(world);
+    glm::mat3 a(glm::abs(m[0]), glm::abs(m[1]), glm::abs(m[2]));
+    glm::vec3 e = a * local.extent;
+    float scale = std::max(glm::length(m[0]), std::max(glm::length(m[1]), glm::length(m[2])));
+    float r = local.radius * scale;
+
+    // fully outside once any plane has dist < -min(box radius, sphere radius)
+#ifdef CULLING_SSE2
+    const __m128 cx = _mm_set1_ps(c.x), cy = _mm_set1_ps(c.y), cz = _mm_set1_ps(c.z);
+    const __m128 ex = _mm_set1_ps(e.x), ey = _mm_set1_ps(e.y), ez = _mm_set1_ps(e.z);
+    const __m128 sr = _mm_set1_ps(r);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    int outside = 0;
+    for (int g = 0; g < 8; g += 4)
+    {
+        __m128 px = _mm_load_ps(nx + g), py = _mm_load_ps(ny + g), pz = _mm_load_ps(nz + g);
+        __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)),
+                                 _mm_add_ps(_mm_mul_ps(pz, cz), _mm_load_ps(nw + g)));
+        __m128 boxR = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(px, absMask), ex),
+                                            _mm_mul_ps(_mm_and_ps(py, absMask), ey)),
+                                 _mm_mul_ps(_mm_and_ps(pz, absMask), ez));
+        __m128 reach = _mm_min_ps(boxR, sr);
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), reach)));
+    }
+    bool visible = (outside == 0);
+#else
+    bool visible = true;
+    for (int p = 0; p < 6 && visible; ++p)
+    {
+        float dist = nx[p] * c.x + ny[p] * c.y + nz[p] * c.z + nw[p];
+        float boxR = std::fabs(nx[p]) * e.x + std::fabs(ny[p]) * e.y + std::fabs(nz[p]) * e.z;
+        visible = dist >= -std::min(boxR, r);
+    }
+#endif
+
+    if (!visible) ++stats.culled;
+    return visible;
+}
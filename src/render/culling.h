@@ -0,0 +1,60 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <glm/glm.hpp>
+
+#include <render/geometry_pool.h>
+
+#include <cstddef>
+#include <iostream>
+
+// ======================================================================
+// Bounding volumes and frustum culling
+// ======================================================================
+//
+// Meshes carry a local AABB and bounding sphere computed when they are
+// built or imported. Per draw, both are moved by the object's world matrix
+// and tested against the six camera planes at once (SSE2, scalar fallback);
+// the object is dropped if either volume is fully outside a plane.
+
+struct Bounds
+{
+    glm::vec3 center = glm::vec3(0.0f);   // AABB center = sphere center
+    glm::vec3 extent = glm::vec3(0.0f);   // AABB half size
+    float radius = 0.0f;                  // sphere around center
+};
+
+Bounds ComputeBounds(const PoolVertex* vertices, size_t count);
+
+struct CullStats
+{
+    unsigned long long tested = 0, culled = 0;
+
+    void Print(std::ostream& os) const
+    {
+        os << "Culling: " << tested << " tested, " << culled << " culled" << std::endl;
+    }
+};
+
+class FrustumCuller
+{
+public:
+    FrustumCuller();
+
+    // clip = projection * view; planes are extracted and normalised once here
+    void SetViewProjection(const glm::mat4& clip);
+
+    // local bounds under a world matrix, counts into stats
+    bool Visible(const Bounds& local, const glm::mat4& world);
+
+    CullStats stats;
+
+private:
+    // planes as SoA, two groups of four (the last two lanes always pass)
+    alignas(16) float nx[8];
+    alignas(16) float ny[8];
+    alignas(16) float nz[8];
+    alignas(16) float nw[8];
+};
+
+#endif
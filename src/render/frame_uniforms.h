@@ -0,0 +1,126 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/shader_m.h>
+
+#include <cstddef>
+#include <cstring>
+
+// ======================================================================
+// Shared std140 uniform blocks
+// ======================================================================
+//
+// Every shader declares the same two blocks (see src/shaders/*.vert):
+//
+//   layout (std140) uniform FrameData { mat4 projection; mat4 view;
+//       vec3 viewPos; float pad0; vec3 lightPos; float pad1; };
+//   layout (std140) uniform LightData { vec3 lightColor; float ambientStrength;
+//       float specularStrength; float shininess; };
+//
+// FrameUniforms owns one buffer per block, bound once to a fixed binding
+// point. Shader binds the block names to the same points for every program
+// linked after Create(), so a new shader only has to declare the block.
+
+enum UniformBlockBinding
+{
+    FRAME_DATA_BINDING = 0,   // camera, once per frame
+    LIGHT_DATA_BINDING = 1    // light parameters, rarely
+};
+
+// C++ mirrors of the std140 layouts (vec3 + float packs into one 16-byte slot)
+struct FrameData
+{
+    glm::mat4 projection;
+    glm::mat4 view;
+    glm::vec3 viewPos;  float pad0;
+    glm::vec3 lightPos; float pad1;
+};
+
+struct LightData
+{
+    glm::vec3 lightColor;
+    float     ambientStrength;
+    float     specularStrength;
+    float     shininess;
+    float     pad2[2];
+};
+
+static_assert(offsetof(FrameData, view) == 64 && offsetof(FrameData, viewPos) == 128 &&
+              offsetof(FrameData, lightPos) == 144 && sizeof(FrameData) == 160,
+              "FrameData must match the std140 block");
+static_assert(offsetof(LightData, ambientStrength) == 12 && offsetof(LightData, shininess) == 20 &&
+              sizeof(LightData) == 32,
+              "LightData must match the std140 block");
+
+class FrameUniforms
+{
+public:
+    FrameUniforms() {}
+    ~FrameUniforms() { Destroy(); }
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // call before the shaders are created so their blocks get the bindings
+    void Create()
+    {
+        Shader::setUniformBlockBinding("FrameData", FRAME_DATA_BINDING);
+        Shader::setUniformBlockBinding("LightData", LIGHT_DATA_BINDING);
+
+        glGenBuffers(1, &frameUbo);
+        glBindBuffer(GL_UNIFORM_BUFFER, frameUbo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, frameUbo);
+
+        glGenBuffers(1, &lightUbo);
+        glBindBuffer(GL_UNIFORM_BUFFER, lightUbo);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(LightData), NULL, GL_STATIC_DRAW);
+        glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_DATA_BINDING, lightUbo);
+
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        frameValid = lightValid = false;
+    }
+
+    void Destroy()
+    {
+        if (frameUbo) glDeleteBuffers(1, &frameUbo);
+        if (lightUbo) glDeleteBuffers(1, &lightUbo);
+        frameUbo = lightUbo = 0;
+    }
+
+    // one upload per frame at most; none when the camera did not move
+    void SetFrame(FrameData data)
+    {
+        data.pad0 = data.pad1 = 0.0f;   // padding takes part in the compare
+        if (frameValid && std::memcmp(&frame, &data, sizeof(FrameData)) == 0)
+            return;
+        frame = data;
+        frameValid = true;
+        glBindBuffer(GL_UNIFORM_BUFFER, frameUbo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &frame);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void SetLight(LightData data)
+    {
+        data.pad2[0] = data.pad2[1] = 0.0f;
+        if (lightValid && std::memcmp(&light, &data, sizeof(LightData)) == 0)
+            return;
+        light = data;
+        lightValid = true;
+        glBindBuffer(GL_UNIFORM_BUFFER, lightUbo);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightData), &light);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+private:
+    unsigned int frameUbo = 0, lightUbo = 0;
+    FrameData frame;
+    LightData light;
+    bool frameValid = false, lightValid = false;
+};
+
+#endif
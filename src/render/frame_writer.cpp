@@ -0,0 +1,141 @@
+#include <render/frame_writer.h>
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+void PutU32(std::vector<unsigned char>& out, uint32_t v)
+{
+    out.push_back((unsigned char)(v >> 24));
+    out.push_back((unsigned char)(v >> 16));
+    out.push_back((unsigned char)(v >> 8));
+    out.push_back((unsigned char)v);
+}
+
+void PutChunk(std::vector<unsigned char>& out, const char type[4], const unsigned char* data, size_t len)
+{
+    PutU32(out, (uint32_t)len);
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    if (len) out.insert(out.end(), data, data + len);
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, &out[start], (uInt)(len + 4));
+    PutU32(out, (uint32_t)crc);
+}
+
+} // namespace
+
+bool WritePNG(const char* path, const unsigned char* rgb, int width, int height, int level)
+{
+    // scanlines with filter type 0 (None): the fast path, level 1 deflate does the rest
+    size_t stride = (size_t)width * 3;
+    std::vector<unsigned char> raw((stride + 1) * height);
+    for (int y = 0; y < height; ++y)
+    {
+        raw[y * (stride + 1)] = 0;
+        std::memcpy(&raw[y * (stride + 1) + 1], rgb + y * stride, stride);
+    }
+
+    uLongf packedLen = compressBound((uLong)raw.size());
+    std::vector<unsigned char> packed(packedLen);
+    if (compress2(packed.data(), &packedLen, raw.data(), (uLong)raw.size(), level) != Z_OK)
+    {
+        std::cout << "PNG: deflate failed for " << path << std::endl;
+        return false;
+    }
+
+    unsigned char ihdr[13];
+    ihdr[0] = (unsigned char)(width >> 24); ihdr[1] = (unsigned char)(width >> 16);
+    ihdr[2] = (unsigned char)(width >> 8);  ihdr[3] = (unsigned char)width;
+    ihdr[4] = (unsigned char)(height >> 24); ihdr[5] = (unsigned char)(height >> 16);
+    ihdr[6] = (unsigned char)(height >> 8);  ihdr[7] = (unsigned char)height;
+    ihdr[8] = 8;    // bit depth
+    ihdr[9] = 2;    // color type: RGB
+    ihdr[10] = 0;   // deflate
+    ihdr[11] = 0;   // adaptive filtering
+    ihdr[12] = 0;   // no interlace
+
+    static const unsigned char kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    std::vector<unsigned char> file(kSignature, kSignature + 8);
+    file.reserve(packedLen + 64);
+    PutChunk(file, "IHDR", ihdr, sizeof(ihdr));
+    PutChunk(file, "IDAT", packed.data(), packedLen);
+    PutChunk(file, "IEND", nullptr, 0);
+
+    FILE* f = std::fopen(path, "wb");
+    if (!f)
+    {
+        std::cout << "PNG: cannot open " << path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(file.data(), 1, file.size(), f) == file.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok)
+        std::cout << "PNG: write failed for " << path << std::endl;
+    return ok;
+}
+
+bool FrameWriter::Open(Format fmt, const std::string& tgt)
+{
+    Close();
+    format = fmt;
+    target = tgt;
+    frames = 0;
+    if (format == RAW)
+    {
+        raw = (target == "-") ? stdout : std::fopen(target.c_str(), "wb");
+        if (!raw)
+        {
+            std::cout << "Headless: cannot open " << target << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void FrameWriter::Close()
+{
+    if (raw && raw != stdout)
+        std::fclose(raw);
+    else if (raw)
+        std::fflush(raw);
+    raw = nullptr;
+}
+
+bool FrameWriter::WriteFrame(const unsigned char* rgba, int width, int height, long frame)
+{
+    // flip to top-down and drop alpha
+    size_t stride = (size_t)width * 3;
+    rgb.resize(stride * height);
+    for (int y = 0; y < height; ++y)
+    {
+        const unsigned char* src = rgba + (size_t)(height - 1 - y) * width * 4;
+        unsigned char* dst = &rgb[y * stride];
+        for (int x = 0; x < width; ++x)
+        {
+            dst[3 * x + 0] = src[4 * x + 0];
+            dst[3 * x + 1] = src[4 * x + 1];
+            dst[3 * x + 2] = src[4 * x + 2];
+        }
+    }
+
+    bool ok;
+    if (format == RAW)
+    {
+        ok = std::fwrite(rgb.data(), 1, rgb.size(), raw) == rgb.size();
+        if (!ok)
+            std::cout << "Headless: raw write failed at frame " << frame << std::endl;
+    }
+    else
+    {
+        char path[1024];
+        std::snprintf(path, sizeof(path), "%s%06ld.png", target.c_str(), frame);
+        ok = WritePNG(path, rgb.data(), width, height);
+    }
+    if (ok) ++frames;
+    return ok;
+}
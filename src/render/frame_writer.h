@@ -0,0 +1,48 @@
+#ifndef FRAME_WRITER_H
+#define FRAME_WRITER_H
+
+#include <render/headless.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ======================================================================
+// Frame output for --headless
+// ======================================================================
+//
+// PNG:  one RGB file per frame, <prefix><frame, 6 digits>.png
+// raw:  every frame appended as top-down RGB24 to one file or stdout ("-"),
+//       e.g. | ffmpeg -f rawvideo -pix_fmt rgb24 -s 768x768 -i - out.mp4
+
+bool WritePNG(const char* path, const unsigned char* rgb, int width, int height, int level = 1);
+
+class FrameWriter : public FrameSink
+{
+public:
+    enum Format { PNG, RAW };
+
+    FrameWriter() {}
+    ~FrameWriter() { Close(); }
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    // target: path prefix for PNG, path or "-" for RAW
+    bool Open(Format format, const std::string& target);
+    void Close();
+
+    // bottom-up RGBA in (GL order), top-down RGB out
+    bool WriteFrame(const unsigned char* rgba, int width, int height, long frame) override;
+
+    long Frames() const { return frames; }
+
+private:
+    Format format = PNG;
+    std::string target;
+    FILE* raw = nullptr;
+    std::vector<unsigned char> rgb;   // reused conversion buffer
+    long frames = 0;
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef GEOMETRY_POOL_H
+#define GEOMETRY_POOL_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <render/vertex_format.h>
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// ======================================================================
+// Shared static geometry
+// ======================================================================
+//
+// Every static mesh (primitives, loaded models) is suballocated out of one
+// vertex buffer and one index buffer with a single vertex format, so the
+// whole scene draws from one VAO. A mesh is just a MeshRange into the pool;
+// draws address it with firstIndex/baseVertex. Meshes are staged on the CPU
+// and uploaded once by Upload(), after which the pool is sealed.
+//
+// Each mesh keeps its own topology and index type: meshes with at most
+// 65535 vertices store 16-bit indices, larger ones 32-bit, side by side in
+// the one index buffer. Strips separate their runs with PrimitiveRestart,
+// which becomes the all-ones value of the stored type (GLStateCache enables
+// restart for every draw).
+//
+// Meshes are staged as PoolVertex; Upload() writes either that or the
+// 16-byte PackedVertex (render/vertex_format.h), see SetVertexFormat().
+// Packing falls back to floats if any mesh is too large or too far from
+// the origin for half positions (HalfPositionsFit()).
+
+struct PoolVertex
+{
+    glm::vec3 position;   // location 0
+    glm::vec3 normal;     // location 1
+    glm::vec2 uv;         // location 2
+};
+
+// strip separator in the indices passed to Add()
+const unsigned int PrimitiveRestart = 0xffffffffu;
+
+struct MeshRange
+{
+    GLenum  mode = GL_TRIANGLES;
+    GLenum  indexType = GL_UNSIGNED_INT;
+    GLsizei count = 0;        // indices, restart markers included
+    GLuint  firstIndex = 0;   // into the pool's index buffer, in units of indexType
+    GLint   baseVertex = 0;   // added to every index
+    GLuint  triangles = 0;
+};
+
+inline GLuint IndexTypeSize(GLenum type)
+{
+    return type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+}
+
+class GeometryPool
+{
+public:
+    GeometryPool() {}
+    ~GeometryPool() { Destroy(); }
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    // indices are local to the mesh (0 = its first vertex), PrimitiveRestart splits strips
+    MeshRange Add(const PoolVertex* v, size_t vertexCount, const unsigned int* idx, size_t indexCount, GLenum mode)
+    {
+        MeshRange r;
+        if (vao)
+        {
+            std::cout << "GeometryPool: Add() after Upload(), mesh dropped" << std::endl;
+            return r;
+        }
+        r.mode = mode;
+        r.indexType = (vertexCount <= 0xffff) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        r.count = (GLsizei)indexCount;
+        r.baseVertex = (GLint)vertices.size();
+
+        // align to the type size, then append
+        const size_t size = IndexTypeSize(r.indexType);
+        indices.resize((indices.size() + size - 1) / size * size);
+        r.firstIndex = (GLuint)(indices.size() / size);
+        indices.resize(indices.size() + indexCount * size);
+        unsigned char* dst = &indices[r.firstIndex * size];
+        if (r.indexType == GL_UNSIGNED_SHORT)
+        {
+            unsigned short* out = reinterpret_cast<unsigned short*>(dst);
+            for (size_t i = 0; i < indexCount; ++i)
+                out[i] = (idx[i] == PrimitiveRestart) ? (unsigned short)0xffff : (unsigned short)idx[i];
+        }
+        else
+        {
+            std::memcpy(dst, idx, indexCount * sizeof(unsigned int));
+        }
+
+        if (vertexCount)
+        {
+            glm::vec3 lo = v[0].position, hi = v[0].position;
+            for (size_t i = 1; i < vertexCount; ++i)
+            {
+                lo = glm::min(lo, v[i].position);
+                hi = glm::max(hi, v[i].position);
+            }
+            if (!HalfPositionsFit(lo, hi))
+                ++unpackable;
+        }
+
+        vertices.insert(vertices.end(), v, v + vertexCount);
+        r.triangles = CountTriangles(idx, indexCount, mode);
+        return r;
+    }
+
+    MeshRange Add(const std::vector<PoolVertex>& v, const std::vector<unsigned int>& idx, GLenum mode)
+    {
+        return Add(v.data(), v.size(), idx.data(), idx.size(), mode);
+    }
+
+    // room for this many more vertices/indices in staging (indices at 32 bits, the worst case)
+    void Reserve(size_t vertexCount, size_t indexCount)
+    {
+        if (vao) return;
+        vertices.reserve(vertices.size() + vertexCount);
+        indices.reserve(indices.size() + indexCount * sizeof(unsigned int) + sizeof(unsigned int));
+    }
+
+    // before Upload(); packed halves the vertex buffer
+    void SetVertexFormat(PoolVertexFormat f)
+    {
+        if (vao)
+            std::cout << "GeometryPool: SetVertexFormat() after Upload() ignored" << std::endl;
+        else
+            format = f;
+    }
+    PoolVertexFormat VertexFormat() const { return format; }
+
+    // upload everything added so far in one go and build the VAO (staging is freed afterwards)
+    bool Upload()
+    {
+        if (vao) return true;
+        if (vertices.empty() || indices.empty())
+        {
+            std::cout << "GeometryPool: nothing to upload" << std::endl;
+            return false;
+        }
+
+        if (format == POOL_VERTEX_PACKED && unpackable)
+        {
+            std::cout << "GeometryPool: " << unpackable << " meshes out of half precision range, using float vertices" << std::endl;
+            format = POOL_VERTEX_FLOAT;
+        }
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vbo);
+        glGenBuffers(1, &ebo);
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        if (format == POOL_VERTEX_PACKED)
+        {
+            std::vector<PackedVertex> packed(vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i)
+                packed[i] = PackVertex(vertices[i].position, vertices[i].normal, vertices[i].uv);
+            vertexBytes = packed.size() * sizeof(PackedVertex);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexBytes, packed.data(), GL_STATIC_DRAW);
+
+            const GLsizei stride = sizeof(PackedVertex);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, position));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, (void*)offsetof(PackedVertex, normal));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex, uv));
+        }
+        else
+        {
+            vertexBytes = vertices.size() * sizeof(PoolVertex);
+            glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexBytes, vertices.data(), GL_STATIC_DRAW);
+
+            const GLsizei stride = sizeof(PoolVertex);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PoolVertex, position));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PoolVertex, normal));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PoolVertex, uv));
+        }
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indices.size(), indices.data(), GL_STATIC_DRAW);
+        glBindVertexArray(0);
+
+        vertexCount = vertices.size();
+        indexBytes = indices.size();
+        std::vector<PoolVertex>().swap(vertices);
+        std::vector<unsigned char>().swap(indices);
+        return true;
+    }
+
+    void Destroy()
+    {
+        if (ebo) glDeleteBuffers(1, &ebo);
+        if (vbo) glDeleteBuffers(1, &vbo);
+        if (vao) glDeleteVertexArrays(1, &vao);
+        vao = vbo = ebo = 0;
+        vertices.clear();
+        indices.clear();
+        vertexCount = vertexBytes = indexBytes = 0;
+        unpackable = 0;
+    }
+
+    // the one VAO every pooled draw uses (0 until Upload())
+    GLuint VAO() const { return vao; }
+
+    size_t VertexCount() const { return vao ? vertexCount : vertices.size(); }
+    size_t IndexBytes() const { return vao ? indexBytes : indices.size(); }
+    size_t VertexBytes() const { return vao ? vertexBytes : vertices.size() * sizeof(PoolVertex); }
+
+private:
+    static GLuint CountTriangles(const unsigned int* idx, size_t count, GLenum mode)
+    {
+        if (mode != GL_TRIANGLE_STRIP) return (GLuint)(count / 3);
+        GLuint tris = 0;
+        size_t run = 0;
+        for (size_t i = 0; i <= count; ++i)
+        {
+            if (i == count || idx[i] == PrimitiveRestart)
+            {
+                if (run > 2) tris += (GLuint)(run - 2);
+                run = 0;
+            }
+            else
+                ++run;
+        }
+        return tris;
+    }
+
+    std::vector<PoolVertex> vertices;    // staging, released by Upload()
+    std::vector<unsigned char> indices;  // 16- and 32-bit ranges, each aligned to its type
+    unsigned int vao = 0, vbo = 0, ebo = 0;
+    size_t vertexCount = 0, vertexBytes = 0, indexBytes = 0;
+    size_t unpackable = 0;                // meshes HalfPositionsFit() rejects
+    PoolVertexFormat format = POOL_VERTEX_FLOAT;
+};
+
+#endif
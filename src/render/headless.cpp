@@ -0,0 +1,296 @@
+#include <render/headless.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+bool HasExtension(const char* list, const char* name)
+{
+    if (!list) return false;
+    size_t n = std::strlen(name);
+    for (const char* p = list; (p = std::strstr(p, name)) != nullptr; p += n)
+    {
+        if ((p == list || p[-1] == ' ') && (p[n] == ' ' || p[n] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------
+// HeadlessContext
+// ----------------------------------------------------------------------
+
+bool HeadlessContext::Create(int major, int minor)
+{
+    Destroy();
+
+    // prefer Mesa's surfaceless platform: no X/Wayland, no GPU device needed
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    const char* clientExt = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay && HasExtension(clientExt, "EGL_MESA_platform_surfaceless"))
+        dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (dpy == EGL_NO_DISPLAY)
+        dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    EGLint vmajor = 0, vminor = 0;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, &vmajor, &vminor))
+    {
+        std::cout << "Headless: no EGL display (eglInitialize failed)" << std::endl;
+        return false;
+    }
+    display = dpy;
+
+    if (!eglBindAPI(EGL_OPENGL_API))
+    {
+        std::cout << "Headless: EGL implementation has no desktop OpenGL" << std::endl;
+        Destroy();
+        return false;
+    }
+
+    const char* ext = eglQueryString(dpy, EGL_EXTENSIONS);
+    bool surfaceless = HasExtension(ext, "EGL_KHR_surfaceless_context");
+
+    static const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = (EGLConfig)0;
+    EGLint numConfigs = 0;
+    eglChooseConfig(dpy, configAttribs, &config, 1, &numConfigs);
+    if (numConfigs == 0)
+    {
+        // the surfaceless platform exposes no pbuffer configs; we render to an FBO anyway
+        if (!HasExtension(ext, "EGL_KHR_no_config_context") || !surfaceless)
+        {
+            std::cout << "Headless: no usable EGL config" << std::endl;
+            Destroy();
+            return false;
+        }
+        config = (EGLConfig)0;   // EGL_NO_CONFIG_KHR
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, major,
+        EGL_CONTEXT_MINOR_VERSION, minor,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, contextAttribs);
+    if (ctx == EGL_NO_CONTEXT)
+    {
+        std::cout << "Headless: cannot create an OpenGL " << major << "." << minor
+                  << " core context (EGL error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+        Destroy();
+        return false;
+    }
+    context = ctx;
+
+    EGLSurface surf = EGL_NO_SURFACE;
+    if (!surfaceless)
+    {
+        // 1x1 pbuffer only to make the context current; drawing goes to the FBO
+        static const EGLint pbufferAttribs[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        surf = eglCreatePbufferSurface(dpy, config, pbufferAttribs);
+        if (surf == EGL_NO_SURFACE)
+        {
+            std::cout << "Headless: cannot create a pbuffer surface" << std::endl;
+            Destroy();
+            return false;
+        }
+        surface = surf;
+    }
+
+    if (!eglMakeCurrent(dpy, surf, surf, ctx))
+    {
+        std::cout << "Headless: eglMakeCurrent failed" << std::endl;
+        Destroy();
+        return false;
+    }
+    return true;
+}
+
+void HeadlessContext::Destroy()
+{
+    if (!display) return;
+    EGLDisplay dpy = (EGLDisplay)display;
+    eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (surface) eglDestroySurface(dpy, (EGLSurface)surface);
+    if (context) eglDestroyContext(dpy, (EGLContext)context);
+    eglTerminate(dpy);
+    display = context = surface = nullptr;
+}
+
+void* HeadlessContext::GetProcAddress(const char* name)
+{
+    return (void*)eglGetProcAddress(name);
+}
+
+// ----------------------------------------------------------------------
+// OffscreenTarget
+// ----------------------------------------------------------------------
+
+bool OffscreenTarget::Create(int w, int h)
+{
+    Destroy();
+    width = w;
+    height = h;
+
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cout << "Headless: framebuffer incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+        Destroy();
+        return false;
+    }
+    return true;
+}
+
+void OffscreenTarget::Destroy()
+{
+    if (fbo) glDeleteFramebuffers(1, &fbo);
+    if (color) glDeleteRenderbuffers(1, &color);
+    if (depth) glDeleteRenderbuffers(1, &depth);
+    fbo = color = depth = 0;
+}
+
+void OffscreenTarget::Bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glViewport(0, 0, width, height);
+}
+
+// ----------------------------------------------------------------------
+// PixelReadback
+// ----------------------------------------------------------------------
+
+bool PixelReadback::Create(int w, int h, int ringSize)
+{
+    Destroy();
+    if (ringSize < 1) ringSize = 1;
+    width = w;
+    height = h;
+    ring = ringSize;
+    slots = new Slot[ring];
+
+    GLsizeiptr bytes = (GLsizeiptr)w * h * 4;
+    for (int i = 0; i < ring; ++i)
+    {
+        glGenBuffers(1, &slots[i].pbo);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slots[i].pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    head = tail = inFlight = 0;
+    stalls = 0;
+    return true;
+}
+
+void PixelReadback::Destroy()
+{
+    if (!slots) return;
+    for (int i = 0; i < ring; ++i)
+    {
+        if (slots[i].fence) glDeleteSync(slots[i].fence);
+        if (slots[i].pbo) glDeleteBuffers(1, &slots[i].pbo);
+    }
+    delete[] slots;
+    slots = nullptr;
+    ring = inFlight = 0;
+}
+
+bool PixelReadback::Deliver(Slot& slot, FrameSink& sink)
+{
+    // flush on the first wait so the fence is guaranteed to signal
+    glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0,
+        (GLsizeiptr)width * height * 4, GL_MAP_READ_BIT);
+    bool ok = pixels && sink.WriteFrame(pixels, width, height, slot.frame);
+    if (pixels)
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    if (!pixels)
+        std::cout << "Headless: cannot map readback buffer for frame " << slot.frame << std::endl;
+    return ok;
+}
+
+bool PixelReadback::Queue(long frame, FrameSink& sink)
+{
+    // hand over whatever the GL has already finished, oldest first
+    while (inFlight > 0)
+    {
+        Slot& s = slots[tail];
+        bool full = (inFlight == ring);
+        if (!full && glClientWaitSync(s.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            break;
+        if (full && glClientWaitSync(s.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            ++stalls;
+        bool ok = Deliver(s, sink);
+        tail = (tail + 1) % ring;
+        --inFlight;
+        if (!ok)
+            return false;
+    }
+
+    Slot& s = slots[head];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // submit now: the polls above never flush, so a buffered fence would only
+    // signal once the ring is full and every frame would stall
+    glFlush();
+    s.frame = frame;
+
+    head = (head + 1) % ring;
+    ++inFlight;
+    return true;
+}
+
+bool PixelReadback::Finish(FrameSink& sink)
+{
+    bool ok = true;
+    while (inFlight > 0)
+    {
+        if (ok)
+            ok = Deliver(slots[tail], sink);
+        else
+        {
+            glDeleteSync(slots[tail].fence);
+            slots[tail].fence = 0;
+        }
+        tail = (tail + 1) % ring;
+        --inFlight;
+    }
+    return ok;
+}
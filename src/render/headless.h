@@ -0,0 +1,113 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <glad/glad.h>
+
+// ======================================================================
+// Offscreen rendering without a window (RobotArm --headless)
+// ======================================================================
+//
+// HeadlessContext: EGL context with no surface. Mesa's surfaceless
+//     platform gives one without X/Wayland or a GPU (llvmpipe).
+// OffscreenTarget: color + depth FBO that replaces the default framebuffer.
+// PixelReadback:   ring of pixel buffer objects. glReadPixels only queues
+//     a copy into the next PBO; a frame is mapped once its fence has
+//     signalled, `ring - 1` frames later, so the CPU never waits on the
+//     frame it just submitted.
+
+class HeadlessContext
+{
+public:
+    HeadlessContext() {}
+    ~HeadlessContext() { Destroy(); }
+
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // core profile context, made current on success
+    bool Create(int major = 3, int minor = 3);
+    void Destroy();
+
+    // loader for gladLoadGLLoader
+    static void* GetProcAddress(const char* name);
+
+private:
+    void* display = nullptr;   // EGLDisplay
+    void* context = nullptr;   // EGLContext
+    void* surface = nullptr;   // EGLSurface, only without EGL_KHR_surfaceless_context
+};
+
+class OffscreenTarget
+{
+public:
+    OffscreenTarget() {}
+    ~OffscreenTarget() { Destroy(); }
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    bool Create(int width, int height);
+    void Destroy();
+
+    // bind for drawing and reading, viewport = whole target
+    void Bind() const;
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+private:
+    unsigned int fbo = 0, color = 0, depth = 0;
+    int width = 0, height = 0;
+};
+
+// receives frames in submission order; rows are bottom-up as GL returns them
+class FrameSink
+{
+public:
+    virtual ~FrameSink() {}
+    virtual bool WriteFrame(const unsigned char* rgba, int width, int height, long frame) = 0;
+};
+
+class PixelReadback
+{
+public:
+    PixelReadback() {}
+    ~PixelReadback() { Destroy(); }
+
+    PixelReadback(const PixelReadback&) = delete;
+    PixelReadback& operator=(const PixelReadback&) = delete;
+
+    bool Create(int width, int height, int ring = 3);
+    void Destroy();
+
+    // read the bound read framebuffer (RGBA8) into the next PBO. Frames that
+    // are already finished are handed to sink first; if the ring is full the
+    // oldest one is waited for. Returns false if the sink failed.
+    bool Queue(long frame, FrameSink& sink);
+
+    // deliver every frame still in flight
+    bool Finish(FrameSink& sink);
+
+    // frames whose fence had not signalled when the ring wrapped around
+    long Stalls() const { return stalls; }
+
+private:
+    struct Slot
+    {
+        unsigned int pbo = 0;
+        GLsync fence = 0;
+        long frame = -1;
+    };
+
+    bool Deliver(Slot& slot, FrameSink& sink);
+
+    Slot* slots = nullptr;
+    int ring = 0;
+    int head = 0;      // next slot to fill
+    int tail = 0;      // oldest slot in flight
+    int inFlight = 0;
+    int width = 0, height = 0;
+    long stalls = 0;
+};
+
+#endif
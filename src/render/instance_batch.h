@@ -0,0 +1,150 @@
+#ifndef INSTANCE_BATCH_H
+#define INSTANCE_BATCH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// ======================================================================
+// Per-frame instance data
+// ======================================================================
+//
+// Every draw reads its model matrix, normal matrix and colour from a
+// PartInstance (vertex attributes with divisor 1) instead of uniforms.
+// The Draw* helpers append to an InstanceBatch per mesh; the batches are
+// packed back to back into the one InstanceBuffer of the frame, and each
+// draw addresses its slice through baseInstance.
+
+// vertex attribute locations used by the instanced shaders (0-2 are the mesh)
+enum InstanceAttrib
+{
+    INSTANCE_ATTRIB_MODEL  = 3,   // mat4 -> 3, 4, 5, 6
+    INSTANCE_ATTRIB_NORMAL = 7,   // mat3 -> 7, 8, 9
+    INSTANCE_ATTRIB_COLOR  = 10
+};
+
+struct PartInstance
+{
+    glm::mat4 model;
+    glm::mat3 normal;   // transpose(inverse(mat3(model)))
+    glm::vec3 color;
+};
+
+inline PartInstance MakePartInstance(const glm::mat4& model, const glm::vec3& color)
+{
+    PartInstance p;
+    p.model  = model;
+    p.normal = glm::transpose(glm::inverse(glm::mat3(model)));
+    p.color  = color;
+    return p;
+}
+
+// CPU-side list for one mesh; capacity is kept across frames
+class InstanceBatch
+{
+public:
+    void Clear() { parts.clear(); }
+    void Add(const glm::mat4& model, const glm::vec3& color)
+    {
+        parts.push_back(MakePartInstance(model, color));
+    }
+
+    GLsizei Count() const { return (GLsizei)parts.size(); }
+    const PartInstance* Data() const { return parts.data(); }
+
+private:
+    std::vector<PartInstance> parts;
+};
+
+// GPU buffer holding every instance of the frame
+class InstanceBuffer
+{
+public:
+    InstanceBuffer() {}
+    ~InstanceBuffer() { Destroy(); }
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    void Create()
+    {
+        if (!vbo) glGenBuffers(1, &vbo);
+    }
+
+    void Destroy()
+    {
+        if (vbo) glDeleteBuffers(1, &vbo);
+        vbo = 0;
+        capacity = 0;
+    }
+
+    void Clear() { staged.clear(); }
+
+    // returns the baseInstance of the appended range
+    GLuint Append(const InstanceBatch& batch)
+    {
+        GLuint base = (GLuint)staged.size();
+        staged.insert(staged.end(), batch.Data(), batch.Data() + batch.Count());
+        return base;
+    }
+
+    GLuint Append(const glm::mat4& model, const glm::vec3& color)
+    {
+        staged.push_back(MakePartInstance(model, color));
+        return (GLuint)staged.size() - 1;
+    }
+
+    // this frame's list to the GPU (the buffer is orphaned and refilled, grown only when needed)
+    void Upload()
+    {
+        if (staged.empty()) return;
+        size_t bytes = staged.size() * sizeof(PartInstance);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        if (bytes > capacity)
+        {
+            capacity = bytes * 2;
+        }
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)capacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)bytes, staged.data());
+    }
+
+    // hooks the instance attributes to the bound VAO; first = where instance 0 is read from
+    // (GL 3.3 has no baseInstance, so there first is moved per draw instead)
+    void BindAttributes(GLuint first = 0) const
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        const GLsizei stride = sizeof(PartInstance);
+        const size_t base = (size_t)first * sizeof(PartInstance);
+        for (int c = 0; c < 4; ++c)
+        {
+            GLuint loc = INSTANCE_ATTRIB_MODEL + c;
+            glEnableVertexAttribArray(loc);
+            glVertexAttribPointer(loc, 4, GL_FLOAT, GL_FALSE, stride,
+                (void*)(base + offsetof(PartInstance, model) + c * sizeof(glm::vec4)));
+            glVertexAttribDivisor(loc, 1);
+        }
+        for (int c = 0; c < 3; ++c)
+        {
+            GLuint loc = INSTANCE_ATTRIB_NORMAL + c;
+            glEnableVertexAttribArray(loc);
+            glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, stride,
+                (void*)(base + offsetof(PartInstance, normal) + c * sizeof(glm::vec3)));
+            glVertexAttribDivisor(loc, 1);
+        }
+        glEnableVertexAttribArray(INSTANCE_ATTRIB_COLOR);
+        glVertexAttribPointer(INSTANCE_ATTRIB_COLOR, 3, GL_FLOAT, GL_FALSE, stride,
+            (void*)(base + offsetof(PartInstance, color)));
+        glVertexAttribDivisor(INSTANCE_ATTRIB_COLOR, 1);
+    }
+
+    GLsizei Count() const { return (GLsizei)staged.size(); }
+
+private:
+    std::vector<PartInstance> staged;   // capacity is kept across frames
+    unsigned int vbo = 0;
+    size_t capacity = 0;
+};
+
+#endif
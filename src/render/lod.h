@@ -0,0 +1,145 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <glm/glm.hpp>
+
+#include <render/culling.h>
+#include <render/geometry_pool.h>
+#include <render/instance_batch.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// ======================================================================
+// Screen-size level of detail
+// ======================================================================
+//
+// Procedural primitives are tessellated at every level up front. Each
+// instance picks its level from the projected radius of its bounding sphere
+// in pixels; a level only changes once the size is a band past the
+// threshold, so instances sitting on a threshold do not pop every frame.
+
+enum { LOD_LEVELS = 4 };
+
+// segments per level, coarse to fine
+const int LodSegments[LOD_LEVELS] = { 8, 16, 32, 64 };
+
+// projected radius (pixels) needed to move up to level i + 1
+const float LodPixelRadius[LOD_LEVELS - 1] = { 10.0f, 32.0f, 96.0f };
+
+const float LodHysteresis = 0.15f;   // +-15% around each threshold
+
+class LodSelector
+{
+public:
+    // projection[1][1] * height / 2 turns radius / distance into pixels
+    void SetView(const glm::vec3& eye, const glm::mat4& projection, int viewportHeight)
+    {
+        camera = eye;
+        pixelScale = projection[1][1] * (float)viewportHeight * 0.5f;
+    }
+
+    float PixelRadius(const Bounds& local, const glm::mat4& world) const
+    {
+        glm::vec3 c = glm::vec3(world * glm::vec4(local.center, 1.0f));
+        float scale = std::fmax(glm::length(glm::vec3(world[0])),
+                      std::fmax(glm::length(glm::vec3(world[1])), glm::length(glm::vec3(world[2]))));
+        float r = local.radius * scale;
+        float d = glm::length(c - camera);
+        if (d <= r) return 1e9f;   // camera inside the sphere
+        return r * pixelScale / d;
+    }
+
+    // previous < 0: no history, take the level without the band
+    int Select(float pixels, int previous, int levels) const
+    {
+        if (previous < 0 || previous >= levels)
+        {
+            int level = 0;
+            while (level + 1 < levels && pixels >= LodPixelRadius[level]) ++level;
+            return level;
+        }
+        int level = previous;
+        while (level + 1 < levels && pixels >= LodPixelRadius[level] * (1.0f + LodHysteresis)) ++level;
+        while (level > 0 && pixels < LodPixelRadius[level - 1] * (1.0f - LodHysteresis)) --level;
+        return level;
+    }
+
+private:
+    glm::vec3 camera = glm::vec3(0.0f);
+    float pixelScale = 1.0f;
+};
+
+struct LodStats
+{
+    unsigned long long frames = 0;
+    unsigned long long draws[LOD_LEVELS] = {};
+    unsigned long long instances[LOD_LEVELS] = {};
+    unsigned long long triangles[LOD_LEVELS] = {};
+
+    void Count(int level, GLsizei count, const MeshRange& range)
+    {
+        ++draws[level];
+        instances[level] += (unsigned long long)count;
+        triangles[level] += (unsigned long long)count * range.triangles;
+    }
+
+    void Print(std::ostream& os) const
+    {
+        double n = frames ? (double)frames : 1.0;
+        os << "LOD (per frame):";
+        for (int i = 0; i < LOD_LEVELS; ++i)
+            os << " [" << LodSegments[i] << " segs] " << draws[i] / n << " draws, "
+               << instances[i] / n << " instances, " << triangles[i] / n << " tris;";
+        os << std::endl;
+    }
+};
+
+// instances of one primitive split by level; the Add() order of a frame
+// identifies an instance, which is what the hysteresis remembers
+class LodInstanceBatch
+{
+public:
+    void Setup(FrustumCuller* frustum, const LodSelector* lod, const Bounds& meshBounds, int levelCount)
+    {
+        culler = frustum;
+        selector = lod;
+        bounds = meshBounds;
+        levels = levelCount;
+    }
+
+    void Clear()
+    {
+        for (int i = 0; i < LOD_LEVELS; ++i) parts[i].Clear();
+        next = 0;
+    }
+
+    void Add(const glm::mat4& model, const glm::vec3& color)
+    {
+        size_t slot = next++;
+        if (slot >= history.size()) history.resize(slot + 1, -1);
+        if (culler && !culler->Visible(bounds, model))
+        {
+            history[slot] = -1;
+            return;
+        }
+        int level = selector ? selector->Select(selector->PixelRadius(bounds, model), history[slot], levels) : 0;
+        history[slot] = (signed char)level;
+        parts[level].Add(model, color);
+    }
+
+    const InstanceBatch& Level(int i) const { return parts[i]; }
+    int Levels() const { return levels; }
+
+private:
+    InstanceBatch parts[LOD_LEVELS];
+    std::vector<signed char> history;   // last level per slot, -1 = none
+    size_t next = 0;
+    FrustumCuller* culler = nullptr;
+    const LodSelector* selector = nullptr;
+    Bounds bounds;
+    int levels = 1;
+};
+
+#endif
@@ -0,0 +1,314 @@
+#include <render/mesh_cache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[8] = { 'R', 'A', 'M', 'E', 'S', 'H', 'C', '\0' };
+
+// file = header, source path (padded to 8), payload
+struct CacheHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t importFlags;
+    int64_t  sourceMtime;
+    uint64_t sourceSize;
+    uint32_t pathLength;
+    uint32_t meshCount;
+    uint64_t payloadBytes;
+    uint64_t checksum;      // FNV-1a 64 over the payload
+};
+
+// payload = per mesh: record, vertices, indices, diffuse path (padded to 4)
+struct MeshRecord
+{
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t mode;
+    uint32_t diffuseLength;
+    float    center[3];
+    float    extent[3];
+    float    radius;
+    uint32_t pad;
+};
+
+static_assert(sizeof(CacheHeader) == 56, "CacheHeader layout");
+static_assert(sizeof(MeshRecord) == 48, "MeshRecord layout");
+static_assert(sizeof(PoolVertex) % 4 == 0, "PoolVertex must keep the payload 4-byte aligned");
+
+size_t Pad(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+uint64_t Fnv1a(const unsigned char* p, size_t n)
+{
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool SourceStamp(const std::string& source, int64_t& mtime, uint64_t& size)
+{
+    std::error_code ec;
+    auto t = std::filesystem::last_write_time(source, ec);
+    if (ec) return false;
+    uintmax_t s = std::filesystem::file_size(source, ec);
+    if (ec) return false;
+    mtime = (int64_t)t.time_since_epoch().count();
+    size = (uint64_t)s;
+    return true;
+}
+
+void Append(std::vector<unsigned char>& out, const void* p, size_t n)
+{
+    const unsigned char* b = static_cast<const unsigned char*>(p);
+    out.insert(out.end(), b, b + n);
+}
+
+} // namespace
+
+// ----------------------------------------------------------------------
+// MappedFile
+// ----------------------------------------------------------------------
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER len;
+    if (!GetFileSizeEx(f, &len) || len.QuadPart == 0)
+    {
+        CloseHandle(f);
+        return false;
+    }
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!m)
+    {
+        CloseHandle(f);
+        return false;
+    }
+    const void* view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+    file = f;
+    mapping = m;
+    data = static_cast<const unsigned char*>(view);
+    size = (size_t)len.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // the mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    data = static_cast<const unsigned char*>(view);
+    size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (!data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mapping);
+    CloseHandle((HANDLE)file);
+    mapping = file = nullptr;
+#else
+    munmap((void*)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+// ----------------------------------------------------------------------
+// MeshCache
+// ----------------------------------------------------------------------
+
+bool MeshCache::Open(const std::string& source, uint32_t importFlags)
+{
+    Close();
+    const std::string path = CachePath(source);
+    if (!file.Open(path))
+        return false;   // no cache yet: not worth a message
+
+    int64_t mtime = 0;
+    uint64_t sourceSize = 0;
+    const unsigned char* base = file.Data();
+    const size_t fileSize = file.Size();
+    CacheHeader h;
+    const char* reason = nullptr;
+
+    if (fileSize < sizeof(CacheHeader))
+        reason = "truncated";
+    else
+    {
+        std::memcpy(&h, base, sizeof(h));
+        if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0)
+            reason = "not a mesh cache";
+        else if (h.version != MeshCacheVersion)
+            reason = "old format version";
+        else if (h.importFlags != importFlags)
+            reason = "import flags changed";
+        else if (!SourceStamp(source, mtime, sourceSize) || h.sourceMtime != mtime || h.sourceSize != sourceSize)
+            reason = "source file changed";
+        else if (h.pathLength != source.size()
+              || sizeof(CacheHeader) + Pad(h.pathLength, 8) + h.payloadBytes != fileSize
+              || std::memcmp(base + sizeof(CacheHeader), source.data(), source.size()) != 0)
+            reason = "different source path or size mismatch";
+    }
+
+    const unsigned char* payload = nullptr;
+    if (!reason)
+    {
+        payload = base + sizeof(CacheHeader) + Pad(h.pathLength, 8);
+        if (Fnv1a(payload, (size_t)h.payloadBytes) != h.checksum)
+            reason = "checksum mismatch";
+    }
+
+    // walk the mesh records checking ranges; vertices/indices point straight into the mapping
+    const unsigned char* p = payload;
+    const unsigned char* end = payload ? payload + h.payloadBytes : nullptr;
+    for (uint32_t i = 0; !reason && i < h.meshCount; ++i)
+    {
+        MeshRecord r;
+        if ((size_t)(end - p) < sizeof(r)) { reason = "truncated mesh record"; break; }
+        std::memcpy(&r, p, sizeof(r));
+        p += sizeof(r);
+
+        size_t bytes = (size_t)r.vertexCount * sizeof(PoolVertex) + (size_t)r.indexCount * sizeof(unsigned int)
+                     + Pad(r.diffuseLength, 4);
+        if ((size_t)(end - p) < bytes) { reason = "truncated mesh data"; break; }
+
+        CachedMesh m;
+        m.vertices = reinterpret_cast<const PoolVertex*>(p);
+        m.vertexCount = r.vertexCount;
+        p += (size_t)r.vertexCount * sizeof(PoolVertex);
+        m.indices = reinterpret_cast<const unsigned int*>(p);
+        m.indexCount = r.indexCount;
+        p += (size_t)r.indexCount * sizeof(unsigned int);
+        m.diffuse.assign(reinterpret_cast<const char*>(p), r.diffuseLength);
+        p += Pad(r.diffuseLength, 4);
+        m.mode = (GLenum)r.mode;
+        m.bounds.center = glm::vec3(r.center[0], r.center[1], r.center[2]);
+        m.bounds.extent = glm::vec3(r.extent[0], r.extent[1], r.extent[2]);
+        m.bounds.radius = r.radius;
+        meshes.push_back(m);
+    }
+
+    if (reason)
+    {
+        std::cout << "Mesh cache " << path << " ignored (" << reason << ")" << std::endl;
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCache::Close()
+{
+    meshes.clear();
+    file.Close();
+}
+
+// ----------------------------------------------------------------------
+// MeshCacheWriter
+// ----------------------------------------------------------------------
+
+void MeshCacheWriter::AddMesh(const PoolVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                              GLenum mode, const Bounds& bounds, const std::string& diffuse)
+{
+    MeshRecord r;
+    std::memset(&r, 0, sizeof(r));
+    r.vertexCount = (uint32_t)vertexCount;
+    r.indexCount = (uint32_t)indexCount;
+    r.mode = (uint32_t)mode;
+    r.diffuseLength = (uint32_t)diffuse.size();
+    r.center[0] = bounds.center.x; r.center[1] = bounds.center.y; r.center[2] = bounds.center.z;
+    r.extent[0] = bounds.extent.x; r.extent[1] = bounds.extent.y; r.extent[2] = bounds.extent.z;
+    r.radius = bounds.radius;
+
+    payload.reserve(payload.size() + sizeof(r) + vertexCount * sizeof(PoolVertex) + indexCount * sizeof(unsigned int) + Pad(diffuse.size(), 4));
+    Append(payload, &r, sizeof(r));
+    Append(payload, vertices, vertexCount * sizeof(PoolVertex));
+    Append(payload, indices, indexCount * sizeof(unsigned int));
+    Append(payload, diffuse.data(), diffuse.size());
+    payload.resize(Pad(payload.size(), 4), 0);
+    ++meshCount;
+}
+
+bool MeshCacheWriter::Save(const std::string& source, uint32_t importFlags) const
+{
+    CacheHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = MeshCacheVersion;
+    h.importFlags = importFlags;
+    if (!SourceStamp(source, h.sourceMtime, h.sourceSize))
+        return false;
+    h.pathLength = (uint32_t)source.size();
+    h.meshCount = meshCount;
+    h.payloadBytes = payload.size();
+    h.checksum = Fnv1a(payload.data(), payload.size());
+
+    // write to a temp file, then rename: a crash never leaves a half-written cache behind
+    const std::string path = MeshCache::CachePath(source);
+    const std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if (!f)
+    {
+        std::cout << "Mesh cache: cannot write " << tmp << std::endl;
+        return false;
+    }
+    static const unsigned char zeros[8] = {};
+    bool ok = std::fwrite(&h, sizeof(h), 1, f) == 1
+           && std::fwrite(source.data(), 1, source.size(), f) == source.size()
+           && std::fwrite(zeros, 1, Pad(source.size(), 8) - source.size(), f) == Pad(source.size(), 8) - source.size()
+           && (payload.empty() || std::fwrite(payload.data(), 1, payload.size(), f) == payload.size());
+    ok = (std::fclose(f) == 0) && ok;
+
+    std::error_code ec;
+    if (ok)
+        std::filesystem::rename(tmp, path, ec);
+    if (!ok || ec)
+    {
+        std::cout << "Mesh cache: write failed for " << path << std::endl;
+        std::filesystem::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <glad/glad.h>
+
+#include <render/culling.h>
+#include <render/geometry_pool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ======================================================================
+// Binary cache of imported meshes
+// ======================================================================
+//
+// After an Assimp import, the processed pool meshes (vertices, indices,
+// bounds, diffuse texture path) are written to <source>.meshcache. On the
+// next load the file is memory-mapped, validated and handed out as views
+// into the mapping, so no importer and no per-vertex work runs at all.
+//
+// The cache is only used when the header matches: magic, format version,
+// source path, source mtime and size, importer flags, and an FNV-1a
+// checksum over the payload. Anything else is a miss and the caller
+// re-imports (and rewrites the cache).
+
+// 2: meshes are stored vertex-cache / fetch optimised
+const uint32_t MeshCacheVersion = 2;
+
+// read-only mapping of a whole file (mmap / MapViewOfFile)
+class MappedFile
+{
+public:
+    MappedFile() {}
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool Open(const std::string& path);
+    void Close();
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+};
+
+// one mesh, pointing into the mapping
+struct CachedMesh
+{
+    const PoolVertex* vertices = nullptr;
+    uint32_t vertexCount = 0;
+    const unsigned int* indices = nullptr;
+    uint32_t indexCount = 0;
+    GLenum mode = GL_TRIANGLES;
+    Bounds bounds;
+    std::string diffuse;   // texture path relative to the model, empty = none
+};
+
+class MeshCache
+{
+public:
+    static std::string CachePath(const std::string& source) { return source + ".meshcache"; }
+
+    // false on a miss; stale or damaged files say why
+    bool Open(const std::string& source, uint32_t importFlags);
+    void Close();
+
+    // valid while the cache stays open
+    const std::vector<CachedMesh>& Meshes() const { return meshes; }
+
+private:
+    MappedFile file;
+    std::vector<CachedMesh> meshes;
+};
+
+// collects meshes during an import, then writes the cache in one go
+class MeshCacheWriter
+{
+public:
+    void AddMesh(const PoolVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount,
+                 GLenum mode, const Bounds& bounds, const std::string& diffuse);
+
+    bool Save(const std::string& source, uint32_t importFlags) const;
+
+private:
+    std::vector<unsigned char> payload;
+    uint32_t meshCount = 0;
+};
+
+#endif
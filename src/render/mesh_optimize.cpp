@@ -0,0 +1,177 @@
+#include <render/mesh_optimize.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006)
+const int kCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriScore = 0.75f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+float VertexScore(int cachePosition, int remaining)
+{
+    if (remaining == 0) return -1.0f;   // no triangle left to pull in
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        if (cachePosition < 3)
+            score = kLastTriScore;   // used by the last triangle: no extra reward for order
+        else
+            score = std::pow(1.0f - (float)(cachePosition - 3) / (float)(kCacheSize - 3), kCacheDecayPower);
+    }
+    // favour vertices with few triangles left, so they get finished off
+    score += kValenceBoostScale * std::pow((float)remaining, -kValenceBoostPower);
+    return score;
+}
+
+} // namespace
+
+double VertexCacheACMR(const unsigned int* indices, size_t indexCount, size_t vertexCount, int cacheSize)
+{
+    if (indexCount < 3) return 0.0;
+    std::vector<size_t> stamp(vertexCount, 0);   // time the vertex entered the FIFO, 0 = never
+    size_t time = 0, misses = 0;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        unsigned int v = indices[i];
+        if (stamp[v] == 0 || time - stamp[v] >= (size_t)cacheSize)
+        {
+            stamp[v] = ++time;
+            ++misses;
+        }
+    }
+    return (double)misses / (double)(indexCount / 3);
+}
+
+void OptimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount)
+{
+    const size_t triCount = indexCount / 3;
+    if (triCount < 2) return;
+
+    // vertex -> triangles (CSR), live ones kept in front of each range
+    std::vector<int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        ++remaining[indices[i]];
+    std::vector<size_t> offset(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        offset[v + 1] = offset[v] + (size_t)remaining[v];
+    std::vector<unsigned int> adjacency(offset[vertexCount]);
+    {
+        std::vector<size_t> fill(offset.begin(), offset.end() - 1);
+        for (size_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+    }
+
+    std::vector<int> cachePos(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = VertexScore(-1, remaining[v]);
+
+    std::vector<float> triScore(triCount);
+    std::vector<char> emitted(triCount, 0);
+    for (size_t t = 0; t < triCount; ++t)
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<unsigned int> out;
+    out.reserve(triCount * 3);
+    unsigned int cache[kCacheSize + 3];
+    int cacheCount = 0;
+
+    size_t best = 0;
+    for (size_t t = 1; t < triCount; ++t)
+        if (triScore[t] > triScore[best]) best = t;
+    size_t scan = 0;   // fallback cursor when the cache has nothing left to offer
+
+    for (size_t n = 0; n < triCount; ++n)
+    {
+        const unsigned int tri[3] = { indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2] };
+        out.insert(out.end(), tri, tri + 3);
+        emitted[best] = 1;
+
+        // drop this triangle from each vertex's remaining list
+        for (int k = 0; k < 3; ++k)
+        {
+            unsigned int v = tri[k];
+            size_t begin = offset[v], end = begin + (size_t)remaining[v];
+            for (size_t a = begin; a < end; ++a)
+                if (adjacency[a] == best)
+                {
+                    std::swap(adjacency[a], adjacency[end - 1]);
+                    break;
+                }
+            --remaining[v];
+        }
+
+        // new cache: this triangle in front, then the old entries
+        unsigned int next[kCacheSize + 3];
+        int nextCount = 0;
+        for (int k = 0; k < 3; ++k)
+            if (std::find(next, next + nextCount, tri[k]) == next + nextCount)
+                next[nextCount++] = tri[k];
+        for (int c = 0; c < cacheCount; ++c)
+            if (std::find(next, next + nextCount, cache[c]) == next + nextCount)
+                next[nextCount++] = cache[c];
+
+        // rescore everything that moved, including what fell out
+        for (int c = 0; c < nextCount; ++c)
+        {
+            unsigned int v = next[c];
+            cachePos[v] = c < kCacheSize ? c : -1;
+            vertexScore[v] = VertexScore(cachePos[v], remaining[v]);
+        }
+        cacheCount = std::min(nextCount, kCacheSize);
+        std::copy(next, next + cacheCount, cache);
+
+        float bestScore = -1.0f;
+        for (int c = 0; c < nextCount; ++c)
+        {
+            unsigned int v = next[c];
+            for (size_t a = offset[v], e = offset[v] + (size_t)remaining[v]; a < e; ++a)
+            {
+                unsigned int t = adjacency[a];
+                float s = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+                triScore[t] = s;
+                if (s > bestScore)
+                {
+                    bestScore = s;
+                    best = t;
+                }
+            }
+        }
+
+        if (bestScore < 0.0f && n + 1 < triCount)
+        {
+            // nothing left around the cache: restart from any triangle not emitted yet
+            while (emitted[scan]) ++scan;
+            best = scan;
+        }
+    }
+
+    std::copy(out.begin(), out.end(), indices);
+}
+
+size_t OptimizeVertexFetch(PoolVertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount)
+{
+    const unsigned int unused = 0xffffffffu;
+    std::vector<unsigned int> remap(vertexCount, unused);
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        unsigned int& r = remap[indices[i]];
+        if (r == unused) r = next++;
+        indices[i] = r;
+    }
+
+    std::vector<PoolVertex> reordered(next);
+    for (size_t v = 0; v < vertexCount; ++v)
+        if (remap[v] != unused)
+            reordered[remap[v]] = vertices[v];
+    std::copy(reordered.begin(), reordered.end(), vertices);
+    return next;
+}
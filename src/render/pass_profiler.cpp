@@ -0,0 +1,230 @@
+#include <render/pass_profiler.h>
+
+#include <cstdio>
+#include <sstream>
+
+void PassProfiler::Create(int averageFrames)
+{
+    Destroy();
+    window = averageFrames > 0 ? averageFrames : 1;
+    frameInWindow = 0;
+    windows = dropped = 0;
+    active = -1;
+    averages.clear();
+    history.clear();
+    created = true;
+    // a re-Create starts from scratch: nothing of the old run leaks into the first window
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        Pass& p = passes[i];
+        glGenQueries(kQueryRing, p.queries);
+        for (int k = 0; k < kQueryRing; ++k)
+            p.pending[k] = false;
+        p.head = 0;
+        p.cpuSum = p.gpuSum = 0.0;
+        p.gpuCount = 0;
+    }
+}
+
+void PassProfiler::Destroy()
+{
+    if (!created) return;
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        glDeleteQueries(kQueryRing, passes[i].queries);
+        for (int k = 0; k < kQueryRing; ++k)
+        {
+            passes[i].queries[k] = 0;
+            passes[i].pending[k] = false;
+        }
+    }
+    created = false;
+}
+
+int PassProfiler::AddPass(const std::string& name)
+{
+    Pass p;
+    p.name = name;
+    if (created)
+        glGenQueries(kQueryRing, p.queries);
+    passes.push_back(p);
+    return (int)passes.size() - 1;
+}
+
+void PassProfiler::Collect(Pass& p, int slot)
+{
+    GLuint64 ns = 0;
+    glGetQueryObjectui64v(p.queries[slot], GL_QUERY_RESULT, &ns);
+    p.pending[slot] = false;
+    p.gpuSum += (double)ns * 1e-6;
+    ++p.gpuCount;
+}
+
+void PassProfiler::Poll(Pass& p)
+{
+    // oldest first; stop at the first result the GL has not finished
+    for (int k = 0; k < kQueryRing; ++k)
+    {
+        int slot = (p.head + k) % kQueryRing;
+        if (!p.pending[slot]) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(p.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) break;
+        Collect(p, slot);
+    }
+}
+
+void PassProfiler::BeginFrame()
+{
+    active = -1;
+}
+
+void PassProfiler::Begin(int pass)
+{
+    if (!created || pass < 0 || pass >= (int)passes.size()) return;
+    if (active >= 0) End();
+
+    Pass& p = passes[pass];
+    if (p.pending[p.head])
+    {
+        // results still missing after a full trip round the ring are dropped, never waited for
+        GLint available = 0;
+        glGetQueryObjectiv(p.queries[p.head], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available)
+            Collect(p, p.head);
+        else
+        {
+            p.pending[p.head] = false;
+            ++dropped;
+        }
+    }
+    glBeginQuery(GL_TIME_ELAPSED, p.queries[p.head]);
+    active = pass;
+    cpuStart = Clock::now();
+}
+
+void PassProfiler::End()
+{
+    if (active < 0) return;
+    Pass& p = passes[active];
+    p.cpuSum += std::chrono::duration<double, std::milli>(Clock::now() - cpuStart).count();
+    glEndQuery(GL_TIME_ELAPSED);
+    p.pending[p.head] = true;
+    p.head = (p.head + 1) % kQueryRing;
+    active = -1;
+}
+
+void PassProfiler::EndFrame()
+{
+    if (!created) return;
+    if (active >= 0) End();
+    for (size_t i = 0; i < passes.size(); ++i)
+        Poll(passes[i]);
+
+    if (++frameInWindow < window) return;
+    CloseWindow();
+}
+
+void PassProfiler::Finish()
+{
+    if (!created) return;
+    if (active >= 0) End();
+    for (size_t i = 0; i < passes.size(); ++i)
+        for (int k = 0; k < kQueryRing; ++k)
+        {
+            int slot = (passes[i].head + k) % kQueryRing;
+            if (passes[i].pending[slot])
+                Collect(passes[i], slot);
+        }
+    if (frameInWindow > 0)
+        CloseWindow();
+}
+
+void PassProfiler::CloseWindow()
+{
+    // GPU results arrive a few frames late, so average over the count received
+    averages.resize(passes.size());
+    for (size_t i = 0; i < passes.size(); ++i)
+    {
+        Pass& p = passes[i];
+        PassTiming& t = averages[i];
+        t.name = p.name;
+        t.cpuMs = p.cpuSum / frameInWindow;
+        t.gpuMs = p.gpuCount ? p.gpuSum / p.gpuCount : 0.0;
+        t.gpuSamples = p.gpuCount;
+        t.frames = frameInWindow;
+        p.cpuSum = p.gpuSum = 0.0;
+        p.gpuCount = 0;
+    }
+    history.push_back(averages);
+    frameInWindow = 0;
+    ++windows;
+}
+
+void PassProfiler::Print(std::ostream& os) const
+{
+    if (averages.empty())
+    {
+        os << "Passes: no full window of " << window << " frames yet" << std::endl;
+        return;
+    }
+    os << "Passes (avg over " << averages[0].frames << " frames, ms cpu/gpu):";
+    for (size_t i = 0; i < averages.size(); ++i)
+        os << " " << averages[i].name << " " << averages[i].cpuMs << "/" << averages[i].gpuMs;
+    os << " (" << dropped << " GPU results dropped)" << std::endl;
+}
+
+std::string PassProfiler::Summary() const
+{
+    std::ostringstream ss;
+    ss.precision(3);
+    for (size_t i = 0; i < averages.size(); ++i)
+    {
+        if (i) ss << "  ";
+        ss << averages[i].name << " " << averages[i].cpuMs << "/" << averages[i].gpuMs << " ms";
+    }
+    return ss.str();
+}
+
+bool PassProfiler::Dump(const std::string& path) const
+{
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f)
+    {
+        std::cout << "Passes: cannot write " << path << std::endl;
+        return false;
+    }
+
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (json)
+    {
+        std::fprintf(f, "{\n  \"window_frames\": %d,\n  \"gpu_dropped\": %ld,\n  \"windows\": [", window, dropped);
+        for (size_t w = 0; w < history.size(); ++w)
+        {
+            std::fprintf(f, "%s\n    [", w ? "," : "");
+            for (size_t i = 0; i < history[w].size(); ++i)
+            {
+                const PassTiming& t = history[w][i];
+                std::fprintf(f, "%s{ \"pass\": \"%s\", \"frames\": %ld, \"cpu_ms\": %.6f, \"gpu_ms\": %.6f, \"gpu_samples\": %ld }",
+                    i ? ", " : "", t.name.c_str(), t.frames, t.cpuMs, t.gpuMs, t.gpuSamples);
+            }
+            std::fprintf(f, "]");
+        }
+        std::fprintf(f, "\n  ]\n}\n");
+    }
+    else
+    {
+        std::fprintf(f, "window,pass,frames,cpu_ms,gpu_ms,gpu_samples\n");
+        for (size_t w = 0; w < history.size(); ++w)
+            for (size_t i = 0; i < history[w].size(); ++i)
+            {
+                const PassTiming& t = history[w][i];
+                std::fprintf(f, "%zu,%s,%ld,%.6f,%.6f,%ld\n", w, t.name.c_str(), t.frames, t.cpuMs, t.gpuMs, t.gpuSamples);
+            }
+    }
+
+    bool ok = std::fclose(f) == 0;
+    if (!ok)
+        std::cout << "Passes: write failed for " << path << std::endl;
+    return ok;
+}
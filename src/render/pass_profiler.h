@@ -0,0 +1,100 @@
+#ifndef PASS_PROFILER_H
+#define PASS_PROFILER_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// ======================================================================
+// CPU + GPU timing per named render pass
+// ======================================================================
+//
+// Begin(pass)/End() bracket a pass on both clocks: steady_clock for the CPU
+// side, a GL_TIME_ELAPSED query for the GPU side. Each pass owns a small
+// ring of query objects and results are only read once the GL reports them
+// available, so timing never stalls the pipeline (a result that is still
+// pending when its slot comes round again is dropped and counted).
+// Both clocks are averaged over the same window of frames; every finished
+// window is kept for Dump() at exit.
+//
+// Passes must not nest or overlap (one GL_TIME_ELAPSED query at a time).
+
+struct PassTiming
+{
+    std::string name;
+    double cpuMs = 0.0;   // average per frame over the window
+    double gpuMs = 0.0;
+    long gpuSamples = 0;  // frames whose GPU result arrived
+    long frames = 0;      // frames in the window (the last one at exit may be short)
+};
+
+class PassProfiler
+{
+public:
+    static const int kQueryRing = 4;
+
+    PassProfiler() {}
+    ~PassProfiler() { Destroy(); }
+
+    PassProfiler(const PassProfiler&) = delete;
+    PassProfiler& operator=(const PassProfiler&) = delete;
+
+    // averageFrames: window length for the averages
+    void Create(int averageFrames = 60);
+    void Destroy();
+
+    // returns the pass index used by Begin()
+    int AddPass(const std::string& name);
+
+    void BeginFrame();
+    void EndFrame();
+
+    // at exit: wait for the outstanding GPU results and close the partial window
+    void Finish();
+
+    void Begin(int pass);
+    void End();
+
+    // averages of the last finished window (empty until the first one)
+    const std::vector<PassTiming>& Averages() const { return averages; }
+    long Windows() const { return windows; }
+    long Dropped() const { return dropped; }
+
+    void Print(std::ostream& os) const;
+    std::string Summary() const;   // one line, e.g. for the window title
+
+    // every finished window; .json -> JSON, anything else -> CSV
+    bool Dump(const std::string& path) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Pass
+    {
+        std::string name;
+        GLuint queries[kQueryRing] = {};
+        bool pending[kQueryRing] = {};
+        int head = 0;
+        double cpuSum = 0.0, gpuSum = 0.0;   // ms, current window
+        long gpuCount = 0;
+    };
+
+    void Collect(Pass& p, int slot);
+    void Poll(Pass& p);
+    void CloseWindow();
+
+    std::vector<Pass> passes;
+    std::vector<PassTiming> averages;
+    std::vector<std::vector<PassTiming> > history;
+    int window = 60;
+    int frameInWindow = 0;
+    long windows = 0, dropped = 0;
+    int active = -1;
+    Clock::time_point cpuStart;
+    bool created = false;
+};
+
+#endif
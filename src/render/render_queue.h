@@ -0,0 +1,390 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <learnopengl/shader_m.h>
+#include <render/instance_batch.h>
+#include <render/pass_profiler.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// ======================================================================
+// GL state shadow
+// ======================================================================
+//
+// Remembers the program / VAO / texture bindings last set through it and
+// drops calls that would not change anything. Code that binds state behind
+// its back (resource setup, texture uploads) must call Forget()/Invalidate().
+
+enum GLStateBits
+{
+    GL_STATE_PROGRAM  = 1u << 0,
+    GL_STATE_VAO      = 1u << 1,
+    GL_STATE_TEXTURES = 1u << 2,   // every unit + the active unit
+    GL_STATE_RESTART  = 1u << 3,   // primitive restart enable + index
+    GL_STATE_ALL      = 0xffffffffu
+};
+
+struct GLStateStats
+{
+    unsigned long long programBinds = 0, programSkips = 0;
+    unsigned long long vaoBinds = 0, vaoSkips = 0;
+    unsigned long long textureBinds = 0, textureSkips = 0;
+    unsigned long long draws = 0;
+    unsigned long long merged = 0;   // commands folded into a multi-draw
+
+    void Print(std::ostream& os) const
+    {
+        os << "GL state: program " << programBinds << " set / " << programSkips << " skipped, "
+           << "VAO " << vaoBinds << " / " << vaoSkips << ", "
+           << "texture " << textureBinds << " / " << textureSkips << ", "
+           << draws << " draws (" << merged << " commands merged)" << std::endl;
+    }
+};
+
+class GLStateCache
+{
+public:
+    static const int kTextureUnits = 16;
+
+    GLStateCache() { Invalidate(); }
+
+    void Invalidate() { Forget(GL_STATE_ALL); }
+
+    void Forget(unsigned bits)
+    {
+        if (bits & GL_STATE_PROGRAM) program = kUnknown;
+        if (bits & GL_STATE_VAO) vao = kUnknown;
+        if (bits & GL_STATE_TEXTURES)
+        {
+            activeUnit = kUnknown;
+            for (int i = 0; i < kTextureUnits; ++i) texture[i] = kUnknown;
+        }
+        if (bits & GL_STATE_RESTART)
+        {
+            restartEnabled = false;
+            restartIndex = kUnknown;
+        }
+    }
+
+    void UseProgram(GLuint id)
+    {
+        if (program == id) { ++stats.programSkips; return; }
+        glUseProgram(id);
+        program = id;
+        ++stats.programBinds;
+    }
+
+    void BindVertexArray(GLuint id)
+    {
+        if (vao == id) { ++stats.vaoSkips; return; }
+        glBindVertexArray(id);
+        vao = id;
+        ++stats.vaoBinds;
+    }
+
+    // restart at the all-ones index of the draw's index type: fixed on 4.3,
+    // otherwise GL_PRIMITIVE_RESTART with the index switched per type
+    void PrimitiveRestart(GLenum indexType)
+    {
+        if (GLAD_GL_VERSION_4_3)
+        {
+            if (!restartEnabled)
+            {
+                glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+                restartEnabled = true;
+            }
+            return;
+        }
+        if (!restartEnabled)
+        {
+            glEnable(GL_PRIMITIVE_RESTART);
+            restartEnabled = true;
+        }
+        GLuint index = indexType == GL_UNSIGNED_BYTE ? 0xffu : indexType == GL_UNSIGNED_SHORT ? 0xffffu : 0xffffffffu;
+        if (index != restartIndex)
+        {
+            glPrimitiveRestartIndex(index);
+            restartIndex = index;
+        }
+    }
+
+    // 2D textures only; that is all this renderer binds
+    void BindTexture2D(int unit, GLuint id)
+    {
+        if (texture[unit] == id) { ++stats.textureSkips; return; }
+        if (activeUnit != (GLuint)unit)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeUnit = (GLuint)unit;
+        }
+        glBindTexture(GL_TEXTURE_2D, id);
+        texture[unit] = id;
+        ++stats.textureBinds;
+    }
+
+    GLStateStats stats;
+
+private:
+    static const GLuint kUnknown = 0xffffffffu;
+    GLuint program, vao, activeUnit;
+    GLuint texture[kTextureUnits];
+    bool restartEnabled;
+    GLuint restartIndex;
+};
+
+// ======================================================================
+// Render command queue
+// ======================================================================
+//
+// Draw helpers record commands during the frame; Flush() sorts them by
+// program, VAO, texture and material and submits them through the state
+// shadow, so consecutive commands that share state issue no binds.
+//
+// Every command draws a range of the shared GeometryPool with a slice of
+// the InstanceBuffer. Commands that end up next to each other with the
+// same state are merged into one
+// glMultiDrawElementsIndirect call; the draw parameters of the whole frame
+// go to the GPU in one buffer upload. Without GL 4.3 they are drawn one by
+// one with baseInstance (4.2) or by re-pointing the instance attributes (3.3).
+//
+// Commands may name a PassProfiler pass; passes sort first, so each pass is
+// submitted in one piece and timed with one CPU/GPU bracket.
+
+// per-object uniforms every lit shader may declare (invalid handles are skipped)
+struct ObjectUniforms
+{
+    Uniform<glm::vec3> ObjColor;
+    Uniform<int> hasTextures;
+};
+
+inline ObjectUniforms ResolveObjectUniforms(const Shader& shader)
+{
+    ObjectUniforms u;
+    u.ObjColor    = shader.uniform<glm::vec3>("ObjColor");
+    u.hasTextures = shader.uniform<int>("hasTextures");
+    return u;
+}
+
+struct RenderMaterial
+{
+    glm::vec3 color;
+    int hasTextures;
+};
+
+struct RenderCommand
+{
+    const Shader*         shader = nullptr;
+    const ObjectUniforms* uniforms = nullptr;
+    GLuint   vao = 0;
+    GLuint   texture = 0;          // bound to unit 0 when non-zero
+    int      material = -1;        // RenderQueue::AddMaterial(), -1 = none
+
+    GLenum   mode = GL_TRIANGLES;
+    GLsizei  count = 0;
+    GLenum   indexType = GL_UNSIGNED_INT;
+    GLsizei  instances = 1;
+    int      pass = -1;            // PassProfiler pass, -1 = untimed
+
+    // range of the shared index buffer + slice of the instance buffer
+    GLuint   firstIndex = 0;
+    GLint    baseVertex = 0;
+    GLuint   baseInstance = 0;
+};
+
+// glMultiDrawElementsIndirect record layout (GL 4.3 spec)
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint  baseVertex;
+    GLuint baseInstance;
+};
+
+class RenderQueue
+{
+public:
+    RenderQueue() {}
+    ~RenderQueue() { Destroy(); }
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // buffer the commands read their per-instance data from
+    void SetInstanceSource(const InstanceBuffer* source) { instanceSource = source; }
+
+    // times RenderCommand::pass brackets during Flush (nullptr = off)
+    void SetProfiler(PassProfiler* passProfiler) { profiler = passProfiler; }
+
+    void Destroy()
+    {
+        if (indirectBuffer) glDeleteBuffers(1, &indirectBuffer);
+        indirectBuffer = 0;
+        indirectCapacity = 0;
+    }
+
+    void Begin()
+    {
+        commands.clear();
+        materials.clear();
+    }
+
+    // identical materials share an index so they sort together
+    int AddMaterial(const glm::vec3& color, int hasTextures)
+    {
+        for (size_t i = 0; i < materials.size(); ++i)
+            if (materials[i].color == color && materials[i].hasTextures == hasTextures)
+                return (int)i;
+        RenderMaterial m;
+        m.color = color;
+        m.hasTextures = hasTextures;
+        materials.push_back(m);
+        return (int)materials.size() - 1;
+    }
+
+    void Submit(const RenderCommand& cmd) { commands.push_back(cmd); }
+
+    size_t Size() const { return commands.size(); }
+
+    void Flush(GLStateCache& state)
+    {
+        std::stable_sort(commands.begin(), commands.end(),
+            [](const RenderCommand& a, const RenderCommand& b)
+            {
+                if (a.pass != b.pass) return a.pass < b.pass;
+                if (a.shader->ID != b.shader->ID) return a.shader->ID < b.shader->ID;
+                if (a.vao != b.vao) return a.vao < b.vao;
+                if (a.texture != b.texture) return a.texture < b.texture;
+                if (a.material != b.material) return a.material < b.material;
+                if (a.mode != b.mode) return a.mode < b.mode;
+                return a.indexType < b.indexType;
+            });
+
+        // draw parameters of the whole frame in sorted order, one upload
+        const bool multiDraw = GLAD_GL_VERSION_4_3 != 0;
+        if (multiDraw)
+            UploadIndirect();
+
+        GLuint indirectSlot = 0;
+        int pass = -1;
+        for (size_t i = 0; i < commands.size(); )
+        {
+            const RenderCommand& c = commands[i];
+            if (profiler && c.pass != pass)
+            {
+                profiler->End();
+                profiler->Begin(c.pass);
+                pass = c.pass;
+            }
+            state.UseProgram(c.shader->ID);
+
+            if (c.uniforms && c.material >= 0)
+            {
+                c.shader->set(c.uniforms->ObjColor, materials[c.material].color);
+                c.shader->set(c.uniforms->hasTextures, materials[c.material].hasTextures);
+            }
+
+            state.BindVertexArray(c.vao);
+            if (c.texture)
+                state.BindTexture2D(0, c.texture);
+            state.PrimitiveRestart(c.indexType);
+
+            size_t run = 1;
+            while (i + run < commands.size() && Mergeable(c, commands[i + run]))
+                ++run;
+
+            if (multiDraw)
+            {
+                glMultiDrawElementsIndirect(c.mode, c.indexType,
+                    (const void*)(indirectSlot * sizeof(DrawElementsIndirectCommand)), (GLsizei)run, 0);
+                indirectSlot += (GLuint)run;
+                ++state.stats.draws;
+                state.stats.merged += run - 1;
+            }
+            else
+            {
+                for (size_t k = i; k < i + run; ++k)
+                    DrawPooled(commands[k], state);
+            }
+            i += run;
+        }
+        if (profiler)
+            profiler->End();
+    }
+
+private:
+    static bool Mergeable(const RenderCommand& a, const RenderCommand& b)
+    {
+        return a.pass == b.pass
+            && a.shader == b.shader && a.uniforms == b.uniforms
+            && a.vao == b.vao && a.texture == b.texture
+            && a.material == b.material
+            && a.mode == b.mode && a.indexType == b.indexType;
+    }
+
+    static GLsizeiptr IndexSize(GLenum type)
+    {
+        return type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4;
+    }
+
+    void UploadIndirect()
+    {
+        indirect.clear();
+        for (size_t i = 0; i < commands.size(); ++i)
+        {
+            const RenderCommand& c = commands[i];
+            DrawElementsIndirectCommand d;
+            d.count = (GLuint)c.count;
+            d.instanceCount = (GLuint)c.instances;
+            d.firstIndex = c.firstIndex;
+            d.baseVertex = c.baseVertex;
+            d.baseInstance = c.baseInstance;
+            indirect.push_back(d);
+        }
+        if (indirect.empty()) return;
+
+        if (!indirectBuffer) glGenBuffers(1, &indirectBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        size_t bytes = indirect.size() * sizeof(DrawElementsIndirectCommand);
+        if (bytes > indirectCapacity)
+            indirectCapacity = bytes * 2;
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)indirectCapacity, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, (GLsizeiptr)bytes, indirect.data());
+    }
+
+    // GL 4.2 / 3.3: one command at a time
+    void DrawPooled(const RenderCommand& c, GLStateCache& state)
+    {
+        const void* offset = (const void*)((size_t)c.firstIndex * IndexSize(c.indexType));
+        if (GLAD_GL_VERSION_4_2)
+        {
+            glDrawElementsInstancedBaseVertexBaseInstance(c.mode, c.count, c.indexType, offset,
+                c.instances, c.baseVertex, c.baseInstance);
+        }
+        else
+        {
+            // no baseInstance: move the instance attributes to the slice instead (VAO is bound)
+            if (instanceSource)
+                instanceSource->BindAttributes(c.baseInstance);
+            glDrawElementsInstancedBaseVertex(c.mode, c.count, c.indexType, offset, c.instances, c.baseVertex);
+        }
+        ++state.stats.draws;
+    }
+
+    std::vector<RenderCommand> commands;    // capacity is kept across frames
+    std::vector<RenderMaterial> materials;
+
+    std::vector<DrawElementsIndirectCommand> indirect;
+    unsigned int indirectBuffer = 0;
+    size_t indirectCapacity = 0;
+    const InstanceBuffer* instanceSource = nullptr;
+    PassProfiler* profiler = nullptr;
+};
+
+#endif
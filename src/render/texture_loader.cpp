@@ -0,0 +1,141 @@
+#include <render/texture_loader.h>
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <iostream>
+
+void TextureLoader::Start(int threads)
+{
+    if (!workers.empty()) return;
+    if (threads <= 0)
+        threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    stopping = false;
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back(&TextureLoader::Work, this);
+}
+
+void TextureLoader::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& w : workers)
+        w.join();
+    workers.clear();
+
+    for (Job& job : decoded)
+        stbi_image_free(job.pixels);
+    if (pending)
+        std::cout << "TextureLoader: " << pending << " textures dropped before upload" << std::endl;
+    queued.clear();
+    decoded.clear();
+    pending = 0;
+}
+
+GLuint TextureLoader::Load(const std::string& path, unsigned int flags)
+{
+    Job job;
+    job.path = path;
+    job.flags = flags;
+    glGenTextures(1, &job.texture);
+
+    if (workers.empty())
+    {
+        Decode(job);
+        Upload(job);
+        return job.texture;
+    }
+
+    GLuint texture = job.texture;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued.push_back(job);
+    }
+    ++pending;
+    wake.notify_one();
+    return texture;
+}
+
+void TextureLoader::Work()
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queued.empty(); });
+            if (stopping) return;
+            job = queued.front();
+            queued.pop_front();
+        }
+        Decode(job);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            decoded.push_back(job);
+        }
+        done.notify_one();
+    }
+}
+
+size_t TextureLoader::Drain()
+{
+    std::deque<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.swap(decoded);
+    }
+    // upload outside the lock so the workers keep decoding meanwhile
+    for (const Job& job : ready)
+        Upload(job);
+    pending -= ready.size();
+    return ready.size();
+}
+
+void TextureLoader::Finish()
+{
+    while (pending)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this] { return !decoded.empty(); });
+        }
+        Drain();
+    }
+}
+
+void TextureLoader::Decode(Job& job)
+{
+    job.pixels = stbi_load(job.path.c_str(), &job.width, &job.height, &job.components, 0);
+}
+
+void TextureLoader::Upload(const Job& job)
+{
+    if (!job.pixels)
+    {
+        std::cout << "Texture failed to load at path: " << job.path << std::endl;
+        return;
+    }
+
+    GLenum format = GL_RGB;
+    if (job.components == 1)
+        format = GL_RED;
+    else if (job.components == 3)
+        format = GL_RGB;
+    else if (job.components == 4)
+        format = GL_RGBA;
+    GLint wrap = (format == GL_RGBA && (job.flags & TEXTURE_CLAMP_RGBA)) ? GL_CLAMP_TO_EDGE : GL_REPEAT;
+
+    glBindTexture(GL_TEXTURE_2D, job.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format, job.width, job.height, 0, format, GL_UNSIGNED_BYTE, job.pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    stbi_image_free(job.pixels);
+}
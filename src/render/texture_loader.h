@@ -0,0 +1,81 @@
+#ifndef TEXTURE_LOADER_H
+#define TEXTURE_LOADER_H
+
+#include <glad/glad.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ======================================================================
+// Texture decoding on worker threads
+// ======================================================================
+//
+// Load() names the texture right away (so meshes and materials can refer
+// to it) and queues the file for a worker; the workers run stbi_load in
+// parallel. Only the GL side stays on the context thread: Drain() uploads
+// whatever has been decoded so far, Finish() waits for the rest.
+//
+// A texture sampled before its upload is incomplete and reads as black,
+// so call Finish() before the first frame that uses it.
+
+enum TextureLoadFlags
+{
+    TEXTURE_REPEAT     = 0,
+    TEXTURE_CLAMP_RGBA = 1u << 0,   // clamp to edge when the image has alpha
+};
+
+class TextureLoader
+{
+public:
+    TextureLoader() {}
+    ~TextureLoader() { Stop(); }
+
+    TextureLoader(const TextureLoader&) = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // threads <= 0: one per core, minus the GL thread
+    void Start(int threads = 0);
+    // joins the workers; images not uploaded yet are dropped
+    void Stop();
+
+    // GL thread; without Start() the file is decoded and uploaded inline
+    GLuint Load(const std::string& path, unsigned int flags = TEXTURE_REPEAT);
+
+    // GL thread: upload the decoded images, never blocks; returns the count
+    size_t Drain();
+    // GL thread: wait for every queued file and upload it
+    void Finish();
+
+    size_t Pending() const { return pending; }
+    int Threads() const { return (int)workers.size(); }
+
+private:
+    struct Job
+    {
+        std::string path;
+        GLuint texture = 0;
+        unsigned int flags = 0;
+        unsigned char* pixels = nullptr;
+        int width = 0, height = 0, components = 0;
+    };
+
+    void Work();
+    static void Decode(Job& job);
+    static void Upload(const Job& job);
+
+    std::vector<std::thread> workers;
+    std::deque<Job> queued;    // waiting for a worker
+    std::deque<Job> decoded;   // waiting for the GL thread
+    std::mutex mutex;
+    std::condition_variable wake;   // workers: new job or stop
+    std::condition_variable done;   // GL thread: a job finished decoding
+    bool stopping = false;
+    size_t pending = 0;   // queued + decoding + decoded, GL thread only
+};
+
+#endif
@@ -0,0 +1,62 @@
+#include <render/texture_registry.h>
+
+#include <filesystem>
+#include <system_error>
+
+TextureRegistry::~TextureRegistry()
+{
+    if (!byId.empty())
+        std::cout << "TextureRegistry: " << byId.size() << " textures still referenced at exit" << std::endl;
+}
+
+std::string TextureRegistry::Key(const std::string& path, unsigned int flags)
+{
+    // normalised so one file reached through different paths maps to a single entry
+    std::error_code ec;
+    std::filesystem::path p = std::filesystem::weakly_canonical(path, ec);
+    if (ec)
+        p = std::filesystem::path(path).lexically_normal();
+    return p.generic_string() + '|' + std::to_string(flags);
+}
+
+GLuint TextureRegistry::Acquire(const std::string& path, unsigned int flags)
+{
+    std::string key = Key(path, flags);
+    auto it = byKey.find(key);
+    if (it != byKey.end())
+    {
+        ++it->second.refs;
+        ++stats.hits;
+        return it->second.texture;
+    }
+
+    TextureLoader& l = loader ? *loader : inlineLoader;
+    Entry e;
+    e.texture = l.Load(path, flags);
+    e.refs = 1;
+    if (!e.texture)
+        return 0;
+    byKey[key] = e;
+    byId[e.texture] = key;
+    ++stats.loads;
+    return e.texture;
+}
+
+void TextureRegistry::Release(GLuint texture)
+{
+    auto id = byId.find(texture);
+    if (id == byId.end())
+    {
+        if (texture)
+            std::cout << "TextureRegistry: Release() of unknown texture " << texture << std::endl;
+        return;
+    }
+    auto it = byKey.find(id->second);
+    if (--it->second.refs > 0)
+        return;
+
+    glDeleteTextures(1, &texture);
+    byKey.erase(it);
+    byId.erase(id);
+    ++stats.releases;
+}
@@ -0,0 +1,72 @@
+#ifndef TEXTURE_REGISTRY_H
+#define TEXTURE_REGISTRY_H
+
+#include <glad/glad.h>
+
+#include <render/texture_loader.h>
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+// ======================================================================
+// Process-wide, reference-counted texture registry
+// ======================================================================
+//
+// Every texture file is loaded once, however many models or primitives use
+// it. Entries are keyed by the canonical path plus the load flags (the
+// flags change sampler state, so they make a different GL texture) and
+// looked up through a hash map. Acquire() loads on a miss through the
+// TextureLoader, Release() deletes the texture with its last user.
+
+struct TextureRegistryStats
+{
+    unsigned long long hits = 0;     // Acquire() served by a resident texture
+    unsigned long long loads = 0;
+    unsigned long long releases = 0; // textures deleted
+
+    void Print(std::ostream& os, size_t resident) const
+    {
+        os << "Textures: " << resident << " resident, " << loads << " loaded, "
+           << hits << " shared, " << releases << " released" << std::endl;
+    }
+};
+
+class TextureRegistry
+{
+public:
+    TextureRegistry() {}
+    // GL is gone by then: whatever is still held is only reported
+    ~TextureRegistry();
+
+    TextureRegistry(const TextureRegistry&) = delete;
+    TextureRegistry& operator=(const TextureRegistry&) = delete;
+
+    // decoding goes through the loader's workers; none = load inline
+    void SetLoader(TextureLoader* textureLoader) { loader = textureLoader; }
+
+    // GL thread; one reference per call, 0 only if GL gave no name
+    GLuint Acquire(const std::string& path, unsigned int flags = TEXTURE_REPEAT);
+    // after the loader has uploaded it (i.e. not between Load and Finish)
+    void Release(GLuint texture);
+
+    size_t Resident() const { return byId.size(); }
+
+    TextureRegistryStats stats;
+
+private:
+    struct Entry
+    {
+        GLuint texture = 0;
+        int refs = 0;
+    };
+
+    static std::string Key(const std::string& path, unsigned int flags);
+
+    std::unordered_map<std::string, Entry> byKey;
+    std::unordered_map<GLuint, std::string> byId;
+    TextureLoader* loader = nullptr;
+    TextureLoader inlineLoader;   // never started: decodes on the calling thread
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// ======================================================================
+// Packed vertex format
+// ======================================================================
+//
+// 16 bytes instead of PoolVertex's 32: half-float position (w = 1 pads it
+// to 8 bytes), normal as signed normalised 10-10-10-2, half-float uv. The
+// attributes still arrive as vec3/vec3/vec2, so shaders do not change.
+// Half positions keep ~11 bits of mantissa, i.e. ~1/2048 relative to the
+// coordinate, not to the mesh: a small mesh far from the origin loses its
+// shape, and anything past 65504 becomes inf. HalfPositionsFit() tells
+// whether a mesh's bounds survive packing.
+
+enum PoolVertexFormat
+{
+    POOL_VERTEX_FLOAT,    // PoolVertex as is
+    POOL_VERTEX_PACKED,   // PackedVertex
+};
+
+struct PackedVertex
+{
+    uint16_t position[4];   // location 0, GL_HALF_FLOAT
+    uint32_t normal;        // location 1, GL_INT_2_10_10_10_REV normalised
+    uint16_t uv[2];         // location 2, GL_HALF_FLOAT
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex layout");
+
+// IEEE 754 binary16, round to nearest even; overflow -> inf, tiny -> subnormal/0
+inline uint16_t HalfFromFloat(float f)
+{
+    uint32_t x;
+    std::memcpy(&x, &f, sizeof(x));
+    uint32_t sign = (x >> 16) & 0x8000u;
+    uint32_t mag = x & 0x7fffffffu;
+
+    if (mag >= 0x7f800000u)   // inf / nan
+        return (uint16_t)(sign | 0x7c00u | (mag > 0x7f800000u ? 0x200u : 0u));
+    if (mag >= 0x477ff000u)   // rounds past 65504
+        return (uint16_t)(sign | 0x7c00u);
+    if (mag < 0x38800000u)    // below the smallest normal half
+    {
+        if (mag < 0x33000000u) return (uint16_t)sign;
+        uint32_t e = mag >> 23;
+        uint32_t m = (mag & 0x7fffffu) | 0x800000u;
+        uint32_t shift = 126 - e;   // 14..24
+        uint32_t h = m >> shift;
+        uint32_t rest = m & ((1u << shift) - 1);
+        uint32_t half = 1u << (shift - 1);
+        if (rest > half || (rest == half && (h & 1u))) ++h;
+        return (uint16_t)(sign | h);
+    }
+    uint32_t h = ((mag - 0x38000000u) >> 13);
+    uint32_t rest = mag & 0x1fffu;
+    if (rest > 0x1000u || (rest == 0x1000u && (h & 1u))) ++h;
+    return (uint16_t)(sign | h);
+}
+
+inline uint32_t SnormComponent10(float v)
+{
+    v = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+    int32_t q = (int32_t)std::lround(v * 511.0f);
+    return (uint32_t)q & 0x3ffu;
+}
+
+// xyz in the low 30 bits, w = 0
+inline uint32_t PackSnorm1010102(const glm::vec3& n)
+{
+    return SnormComponent10(n.x) | (SnormComponent10(n.y) << 10) | (SnormComponent10(n.z) << 20);
+}
+
+// true if half positions resolve a mesh with these bounds to ~1/1024 of its
+// size (the precision of the packed normals)
+inline bool HalfPositionsFit(const glm::vec3& lo, const glm::vec3& hi)
+{
+    float maxAbs = glm::max(glm::max(glm::max(std::fabs(lo.x), std::fabs(hi.x)),
+                                     glm::max(std::fabs(lo.y), std::fabs(hi.y))),
+                            glm::max(std::fabs(lo.z), std::fabs(hi.z)));
+    if (!(maxAbs < 65504.0f))   // also catches nan
+        return false;
+    if (maxAbs < 6.103515625e-05f)   // subnormal range: fixed 2^-24 steps
+        return true;
+    glm::vec3 size = hi - lo;
+    float extent = glm::max(glm::max(size.x, size.y), size.z);
+    int e;
+    std::frexp(maxAbs, &e);               // maxAbs in [2^(e-1), 2^e)
+    float step = std::ldexp(1.0f, e - 11);   // half spacing there
+    return step * 512.0f <= extent;       // rounding error (step / 2) <= extent / 1024
+}
+
+inline PackedVertex PackVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv)
+{
+    PackedVertex p;
+    p.position[0] = HalfFromFloat(position.x);
+    p.position[1] = HalfFromFloat(position.y);
+    p.position[2] = HalfFromFloat(position.z);
+    p.position[3] = 0x3c00u;   // 1.0
+    p.normal = PackSnorm1010102(normal);
+    p.uv[0] = HalfFromFloat(uv.x);
+    p.uv[1] = HalfFromFloat(uv.y);
+    return p;
+}
+
+#endif
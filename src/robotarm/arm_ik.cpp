@@ -0,0 +1,137 @@
+#include <robotarm/arm_ik.h>
+
+#include <cmath>
+
+namespace {
+
+const float kPi = 3.14159265358979323846f;
+
+// in (-180, 180]; inputs here are within a few turns, so no fmod
+float WrapDegrees(float deg)
+{
+    while (deg <= -180.0f) deg += 360.0f;
+    while (deg > 180.0f) deg -= 360.0f;
+    return deg;
+}
+
+unsigned CheckLimits(const float joint[IK_DOF], const ArmJointLimits& limits)
+{
+    unsigned mask = 0;
+    for (int i = 0; i < IK_DOF; ++i)
+    {
+        int dof = DOF_BASE_SPIN + i;
+        if (joint[i] < limits.lo[dof] || joint[i] > limits.hi[dof])
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+} // namespace
+
+IKResult SolveArmIK(const glm::mat4& palmTarget, float baseX, float baseZ,
+                    const ArmJointLimits& limits, float yawHintDeg)
+{
+    const float L1 = kUpperArmLen, L2 = kForearmLen, L3 = kPalmOffset;
+    const float kEps = 1e-6f;
+
+    IKResult result;
+    result.status = IKStatus::Unreachable;
+    result.count = 0;
+    result.orientationError = 0.0f;
+
+    glm::vec3 p(palmTarget[3].x - baseX, palmTarget[3].y, palmTarget[3].z - baseZ);
+    glm::vec3 xAxis = glm::normalize(glm::vec3(palmTarget[0]));
+    glm::vec3 yAxis = glm::normalize(glm::vec3(palmTarget[1]));
+
+    // yaw that puts the target in the arm plane (plane X axis = Ry(yaw) * (1,0,0))
+    float r = std::sqrt(p.x * p.x + p.z * p.z);
+    float yaw0 = (r > kEps) ? std::atan2(-p.z, p.x) : glm::radians(yawHintDeg);
+
+    bool anyWithinLimits = false;
+    for (int b = 0; b < 2; ++b)
+    {
+        float yaw = yaw0 + b * kPi;
+        float c = std::cos(yaw), s = std::sin(yaw);
+
+        // target position / palm Y axis in the arm plane: Ry(-yaw) * v
+        float px = c * p.x - s * p.z;
+        float py = p.y;
+        float vx = c * yAxis.x - s * yAxis.z;
+        float vy = yAxis.y;
+        float vz = s * yAxis.x + c * yAxis.z;
+        if (b == 0)
+            result.orientationError = std::asin(glm::clamp(std::fabs(vz), 0.0f, 1.0f));
+
+        // accumulated pitch of the palm, link direction is (-sin, cos)
+        float phi = std::atan2(-vx, vy);
+        float sphi = std::sin(phi), cphi = std::cos(phi);
+
+        // wrist joint relative to the shoulder
+        float x = px + L3 * sphi;
+        float y = py - L3 * cphi - kShoulderHeight;
+
+        float D = (x * x + y * y - L1 * L1 - L2 * L2) / (2.0f * L1 * L2);
+        if (D > 1.0f + 1e-4f || D < -1.0f - 1e-4f)
+            continue;
+        D = glm::clamp(D, -1.0f, 1.0f);
+
+        // wrist twist: Ry(twist) = (Ry(yaw) * Rz(phi))^T * R
+        glm::vec3 a0(c * cphi, sphi, -s * cphi);
+        glm::vec3 a2(s, 0.0f, c);
+        float twist = std::atan2(-glm::dot(a2, xAxis), glm::dot(a0, xAxis));
+
+        // both elbow branches collapse into one at full stretch / fold
+        int branches = (D >= 1.0f || D <= -1.0f) ? 1 : 2;
+        float acosD = std::acos(D);
+        float sinD = std::sqrt(1.0f - D * D);   // sin(acos(D))
+        float psiW = std::atan2(y, x);
+        for (int e = 0; e < branches; ++e)
+        {
+            int sign = (e == 0) ? 1 : -1;
+            float t2 = sign * acosD;
+            float psi1 = psiW - std::atan2(L2 * sign * sinD, L1 + L2 * D);
+            float t1 = psi1 - 0.5f * kPi;
+            float t3 = phi - t1 - t2;
+
+            IKSolution& sol = result.solutions[result.count++];
+            sol.joint[IK_BASE_SPIN]   = WrapDegrees(glm::degrees(yaw));
+            sol.joint[IK_SHOULDER]    = WrapDegrees(glm::degrees(t1));
+            sol.joint[IK_ELBOW]       = WrapDegrees(glm::degrees(t2));
+            sol.joint[IK_WRIST]       = WrapDegrees(glm::degrees(t3));
+            sol.joint[IK_WRIST_TWIST] = WrapDegrees(glm::degrees(twist));
+            sol.limitViolations = CheckLimits(sol.joint, limits);
+            sol.backward = (b == 1);
+            sol.elbowSign = sign;
+            anyWithinLimits |= (sol.limitViolations == 0);
+        }
+    }
+
+    if (result.count > 0)
+        result.status = anyWithinLimits ? IKStatus::Ok : IKStatus::JointLimits;
+    return result;
+}
+
+int SelectClosestIKSolution(const IKResult& result, const float current[IK_DOF])
+{
+    int best = -1;
+    float bestCost = 0.0f;
+    for (int i = 0; i < result.count; ++i)
+    {
+        const IKSolution& sol = result.solutions[i];
+        if (sol.limitViolations)
+            continue;
+
+        float cost = 0.0f;
+        for (int j = 0; j < IK_DOF; ++j)
+        {
+            float d = WrapDegrees(sol.joint[j] - current[j]);
+            cost += d * d;
+        }
+        if (best < 0 || cost < bestCost)
+        {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
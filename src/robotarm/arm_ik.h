@@ -0,0 +1,59 @@
+#ifndef ARM_IK_H
+#define ARM_IK_H
+
+#include <robotarm/robot_arm.h>
+
+// ======================================================================
+// Closed-form inverse kinematics for the 5-DOF arm
+// ======================================================================
+//
+// Yaw (BaseSpin) puts the palm in a vertical plane, shoulder/elbow/wrist are
+// planar pitch joints about Z inside that plane, and the wrist twist about Y
+// sets the roll. A palm target therefore has at most 4 solutions:
+// {front, back over the top} x {elbow +, elbow -}.
+
+// joints solved by the IK, in ArmDof order starting at DOF_BASE_SPIN
+enum IKJoint
+{
+    IK_BASE_SPIN,
+    IK_SHOULDER,
+    IK_ELBOW,
+    IK_WRIST,
+    IK_WRIST_TWIST,
+    IK_DOF
+};
+
+const int kMaxIKSolutions = 4;
+
+enum class IKStatus
+{
+    Ok,             // at least one solution within joint limits
+    JointLimits,    // reachable, but every solution breaks a limit
+    Unreachable     // palm position is outside the workspace
+};
+
+struct IKSolution
+{
+    float    joint[IK_DOF];     // degrees, wrapped to (-180, 180]
+    unsigned limitViolations;   // bit i set = joint i outside its limits
+    bool     backward;          // yaw flipped by 180 deg, arm reaches over the top
+    int      elbowSign;         // +1 / -1 elbow branch
+};
+
+struct IKResult
+{
+    IKStatus   status;
+    int        count;                       // geometric solutions found (incl. limit violations)
+    IKSolution solutions[kMaxIKSolutions];
+    float      orientationError;            // radians the palm Y axis leaves the arm plane (5 DOF cannot follow)
+};
+
+// Solves for a world palm pose (same frame as RobotChain.World(LINK_PALM)) with the
+// base held at (baseX, baseZ). yawHintDeg is used when the target is straight above the base.
+IKResult SolveArmIK(const glm::mat4& palmTarget, float baseX, float baseZ,
+                    const ArmJointLimits& limits, float yawHintDeg = 0.0f);
+
+// index of the within-limits solution closest to current (IK_DOF angles), or -1
+int SelectClosestIKSolution(const IKResult& result, const float current[IK_DOF]);
+
+#endif
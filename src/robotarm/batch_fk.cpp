@@ -0,0 +1,121 @@
+#include <robotarm/batch_fk_kernel.h>
+
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// one configuration at a time; also handles the tail of the SIMD paths
+struct ScalarOps
+{
+    typedef float V;
+    typedef int   I;
+    typedef bool  M;
+    static const size_t Width = 1;
+
+    static V Set(float v)               { return v; }
+    static V Load(const float* p)       { return *p; }
+    static void Store(float* p, V v)    { *p = v; }
+    static V Add(V a, V b)              { return a + b; }
+    static V Sub(V a, V b)              { return a - b; }
+    static V Mul(V a, V b)              { return a * b; }
+    static V Neg(V a)                   { return -a; }
+    // round-half-even, same as cvtps2dq under the default MXCSR mode
+    static I RoundToInt(V a)            { return (int)std::nearbyint(a); }
+    static V ToFloat(I a)               { return (float)a; }
+    static I AddInt(I a, int b)         { return a + b; }
+    static M TestBit(I a, int bit)      { return (a & bit) != 0; }
+    static V Select(M m, V a, V b)      { return m ? a : b; }
+    static V NegateIf(M m, V a)         { return m ? -a : a; }
+};
+
+bool CpuSupports(FKKernel kernel)
+{
+#if defined(ROBOTARM_SIMD_X86)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse2    = (info[3] & (1 << 26)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    unsigned long long xcr0 = (osxsave && avx) ? _xgetbv(0) : 0;
+    bool ymm = (xcr0 & 0x6) == 0x6;
+    bool zmm = (xcr0 & 0xe6) == 0xe6;
+    bool avx2 = false, avx512f = false;
+    if (maxLeaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2    = (info[1] & (1 << 5)) != 0;
+        avx512f = (info[1] & (1 << 16)) != 0;
+    }
+    switch (kernel)
+    {
+    case FKKernel::SSE:    return sse2;
+    case FKKernel::AVX2:   return ymm && avx2;
+    case FKKernel::AVX512: return zmm && avx512f;
+    default:               return true;
+    }
+#else
+    __builtin_cpu_init();
+    switch (kernel)
+    {
+    case FKKernel::SSE:    return __builtin_cpu_supports("sse2");
+    case FKKernel::AVX2:   return __builtin_cpu_supports("avx2");
+    case FKKernel::AVX512: return __builtin_cpu_supports("avx512f");
+    default:               return true;
+    }
+#endif
+#else
+    return kernel == FKKernel::Scalar || kernel == FKKernel::Auto;
+#endif
+}
+
+} // namespace
+
+FKKernel DetectFKKernel()
+{
+    static const FKKernel best =
+        CpuSupports(FKKernel::AVX512) ? FKKernel::AVX512 :
+        CpuSupports(FKKernel::AVX2)   ? FKKernel::AVX2 :
+        CpuSupports(FKKernel::SSE)    ? FKKernel::SSE : FKKernel::Scalar;
+    return best;
+}
+
+const char* FKKernelName(FKKernel kernel)
+{
+    switch (kernel)
+    {
+    case FKKernel::Auto:   return "auto";
+    case FKKernel::Scalar: return "scalar";
+    case FKKernel::SSE:    return "sse";
+    case FKKernel::AVX2:   return "avx2";
+    case FKKernel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+FKKernel BatchForwardKinematics(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count, FKKernel kernel)
+{
+    // never run a kernel the CPU cannot execute: step down to the best supported one
+    FKKernel best = DetectFKKernel();
+    if (kernel == FKKernel::Auto || (int)kernel > (int)best)
+        kernel = best;
+
+    size_t done = 0;
+    switch (kernel)
+    {
+    case FKKernel::SSE:    done = batchfk::ForwardKinematicsSSE(in, out, count); break;
+    case FKKernel::AVX2:   done = batchfk::ForwardKinematicsAVX2(in, out, count); break;
+    case FKKernel::AVX512: done = batchfk::ForwardKinematicsAVX512(in, out, count); break;
+    default: break;
+    }
+    for (; done < count; ++done)
+        batchfk::ForwardKinematicsBlock<ScalarOps>(in, out, done);
+    return kernel;
+}
@@ -0,0 +1,54 @@
+#ifndef BATCH_FK_H
+#define BATCH_FK_H
+
+#include <robotarm/robot_arm.h>
+
+#include <cstddef>
+
+// ======================================================================
+// Batched forward kinematics (structure-of-arrays in / out)
+// ======================================================================
+
+// N joint configurations, one array per DOF (same units as the globals: degrees / world units)
+struct ArmJointsSoA
+{
+    const float* dof[ARM_DOF];
+};
+
+// N rigid poses. rot[] is the column-major 3x3 rotation (rot[0..2] = X axis, ...);
+// leave rot[0] == nullptr to skip it, leave x == nullptr to skip the whole pose.
+struct PoseSoA
+{
+    float* x;
+    float* y;
+    float* z;
+    float* rot[9];
+};
+
+struct ArmPosesSoA
+{
+    PoseSoA palm;   // LINK_PALM frame
+    PoseSoA tip1;   // finger 1 tip (cone apex, kFingerTipLen past LINK_FINGER1_TIP)
+    PoseSoA tip2;   // finger 2 tip
+};
+
+enum class FKKernel
+{
+    Auto,
+    Scalar,
+    SSE,
+    AVX2,
+    AVX512
+};
+
+// best kernel supported by both this build and the running CPU
+FKKernel DetectFKKernel();
+const char* FKKernelName(FKKernel kernel);
+
+// Evaluates count configurations and returns the kernel that was actually used.
+// All kernels run the same operation sequence (own sin/cos, no FMA contraction),
+// so the scalar fallback is bit-identical to the SIMD paths.
+FKKernel BatchForwardKinematics(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count,
+                                FKKernel kernel = FKKernel::Auto);
+
+#endif
@@ -0,0 +1,51 @@
+#include <robotarm/batch_fk_kernel.h>
+
+#if defined(ROBOTARM_SIMD_X86)
+#include <immintrin.h>
+
+namespace {
+
+// 8 lanes. Built with -mavx2 (no -mfma) so mul/add stay separate like the scalar path.
+struct AVX2Ops
+{
+    typedef __m256  V;
+    typedef __m256i I;
+    typedef __m256  M;
+    static const size_t Width = 8;
+
+    static V Set(float v)               { return _mm256_set1_ps(v); }
+    static V Load(const float* p)       { return _mm256_loadu_ps(p); }
+    static void Store(float* p, V v)    { _mm256_storeu_ps(p, v); }
+    static V Add(V a, V b)              { return _mm256_add_ps(a, b); }
+    static V Sub(V a, V b)              { return _mm256_sub_ps(a, b); }
+    static V Mul(V a, V b)              { return _mm256_mul_ps(a, b); }
+    static V Neg(V a)                   { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static I RoundToInt(V a)            { return _mm256_cvtps_epi32(a); }
+    static V ToFloat(I a)               { return _mm256_cvtepi32_ps(a); }
+    static I AddInt(I a, int b)         { return _mm256_add_epi32(a, _mm256_set1_epi32(b)); }
+    static M TestBit(I a, int bit)
+    {
+        __m256i b = _mm256_set1_epi32(bit);
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, b), b));
+    }
+    static V Select(M m, V a, V b)      { return _mm256_blendv_ps(b, a, m); }
+    static V NegateIf(M m, V a)         { return _mm256_xor_ps(a, _mm256_and_ps(m, _mm256_set1_ps(-0.0f))); }
+};
+
+} // namespace
+
+size_t batchfk::ForwardKinematicsAVX2(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count)
+{
+    size_t done = ForwardKinematicsBlocks<AVX2Ops>(in, out, count);
+    _mm256_zeroupper();
+    return done;
+}
+
+#else
+
+size_t batchfk::ForwardKinematicsAVX2(const ArmJointsSoA&, const ArmPosesSoA&, size_t)
+{
+    return 0;
+}
+
+#endif
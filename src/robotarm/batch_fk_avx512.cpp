@@ -0,0 +1,50 @@
+#include <robotarm/batch_fk_kernel.h>
+
+#if defined(ROBOTARM_SIMD_X86)
+#include <immintrin.h>
+
+namespace {
+
+// 16 lanes, AVX-512F with mask registers for the quadrant selects
+struct AVX512Ops
+{
+    typedef __m512    V;
+    typedef __m512i   I;
+    typedef __mmask16 M;
+    static const size_t Width = 16;
+
+    static V Set(float v)               { return _mm512_set1_ps(v); }
+    static V Load(const float* p)       { return _mm512_loadu_ps(p); }
+    static void Store(float* p, V v)    { _mm512_storeu_ps(p, v); }
+    static V Add(V a, V b)              { return _mm512_add_ps(a, b); }
+    static V Sub(V a, V b)              { return _mm512_sub_ps(a, b); }
+    static V Mul(V a, V b)              { return _mm512_mul_ps(a, b); }
+    static V Neg(V a)
+    {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32((int)0x80000000u)));
+    }
+    static I RoundToInt(V a)            { return _mm512_cvtps_epi32(a); }
+    static V ToFloat(I a)               { return _mm512_cvtepi32_ps(a); }
+    static I AddInt(I a, int b)         { return _mm512_add_epi32(a, _mm512_set1_epi32(b)); }
+    static M TestBit(I a, int bit)      { return _mm512_test_epi32_mask(a, _mm512_set1_epi32(bit)); }
+    static V Select(M m, V a, V b)      { return _mm512_mask_blend_ps(m, b, a); }
+    static V NegateIf(M m, V a)         { return _mm512_mask_mov_ps(a, m, Neg(a)); }
+};
+
+} // namespace
+
+size_t batchfk::ForwardKinematicsAVX512(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count)
+{
+    size_t done = ForwardKinematicsBlocks<AVX512Ops>(in, out, count);
+    _mm256_zeroupper();
+    return done;
+}
+
+#else
+
+size_t batchfk::ForwardKinematicsAVX512(const ArmJointsSoA&, const ArmPosesSoA&, size_t)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef BATCH_FK_KERNEL_H
+#define BATCH_FK_KERNEL_H
+
+// Shared FK kernel, instantiated once per instruction set (batch_fk*.cpp).
+// Only include this from those files: every kernel must see the exact same
+// operation order for the results to stay bit-identical.
+//
+// An Ops type provides:
+//   V (float lanes), I (int32 lanes), M (lane mask), Width
+//   Set, Load, Store, Add, Sub, Mul, Neg, RoundToInt, ToFloat, AddInt, TestBit, Select, NegateIf
+
+#include <robotarm/batch_fk.h>
+#include <robotarm/fast_trig.h>
+
+namespace batchfk {
+
+using namespace fasttrig;
+
+// vector form of fasttrig::SinCosDeg (round-half-even instead of half-away, otherwise identical)
+template <class Ops>
+inline void SinCosDeg(typename Ops::V deg, typename Ops::V& s, typename Ops::V& c)
+{
+    typedef typename Ops::V V;
+    typedef typename Ops::I I;
+
+    V x = Ops::Mul(deg, Ops::Set(kDegToRad));
+    I q = Ops::RoundToInt(Ops::Mul(x, Ops::Set(kTwoOverPi)));
+    V j = Ops::ToFloat(q);
+
+    V r = Ops::Sub(x, Ops::Mul(j, Ops::Set(kPio2A)));
+    r = Ops::Sub(r, Ops::Mul(j, Ops::Set(kPio2B)));
+    r = Ops::Sub(r, Ops::Mul(j, Ops::Set(kPio2C)));
+    V z = Ops::Mul(r, r);
+
+    V ps = Ops::Add(Ops::Mul(Ops::Mul(z, r), Ops::Add(Ops::Mul(Ops::Add(Ops::Mul(Ops::Set(kSin0), z), Ops::Set(kSin1)), z), Ops::Set(kSin2))), r);
+    V pc = Ops::Mul(Ops::Add(Ops::Mul(Ops::Add(Ops::Mul(Ops::Set(kCos0), z), Ops::Set(kCos1)), z), Ops::Set(kCos2)), Ops::Mul(z, z));
+    pc = Ops::Add(Ops::Sub(pc, Ops::Mul(Ops::Set(0.5f), z)), Ops::Set(1.0f));
+
+    // quadrant: 1,3 swap sin/cos; sin < 0 in 2,3; cos < 0 in 1,2
+    typename Ops::M swap   = Ops::TestBit(q, 1);
+    typename Ops::M sinNeg = Ops::TestBit(q, 2);
+    typename Ops::M cosNeg = Ops::TestBit(Ops::AddInt(q, 1), 2);
+
+    s = Ops::NegateIf(sinNeg, Ops::Select(swap, pc, ps));
+    c = Ops::NegateIf(cosNeg, Ops::Select(swap, ps, pc));
+}
+
+// rotation columns r[0..2] = X, r[3..5] = Y, r[6..8] = Z, translation t
+template <class Ops>
+struct Frame
+{
+    typename Ops::V r[9];
+    typename Ops::V t[3];
+};
+
+// F = F * T(axis k * d)
+template <class Ops>
+inline void Translate(Frame<Ops>& F, int k, typename Ops::V d)
+{
+    for (int i = 0; i < 3; ++i)
+        F.t[i] = Ops::Add(F.t[i], Ops::Mul(F.r[3 * k + i], d));
+}
+
+// F = F * R(axis, angle) for axis Y (a = 2, b = 0) or Z (a = 0, b = 1):
+//   col a' = col a * c + col b * s,  col b' = col b * c - col a * s
+template <class Ops>
+inline void Rotate(Frame<Ops>& F, int a, int b, typename Ops::V c, typename Ops::V s)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        typename Ops::V ca = F.r[3 * a + i];
+        typename Ops::V cb = F.r[3 * b + i];
+        F.r[3 * a + i] = Ops::Add(Ops::Mul(ca, c), Ops::Mul(cb, s));
+        F.r[3 * b + i] = Ops::Sub(Ops::Mul(cb, c), Ops::Mul(ca, s));
+    }
+}
+
+template <class Ops>
+inline void RotateY(Frame<Ops>& F, typename Ops::V c, typename Ops::V s) { Rotate<Ops>(F, 2, 0, c, s); }
+
+template <class Ops>
+inline void RotateZ(Frame<Ops>& F, typename Ops::V c, typename Ops::V s) { Rotate<Ops>(F, 0, 1, c, s); }
+
+template <class Ops>
+inline void StorePose(const PoseSoA& p, size_t i, const Frame<Ops>& F)
+{
+    if (!p.x) return;
+    Ops::Store(p.x + i, F.t[0]);
+    Ops::Store(p.y + i, F.t[1]);
+    Ops::Store(p.z + i, F.t[2]);
+    if (p.rot[0])
+        for (int k = 0; k < 9; ++k)
+            Ops::Store(p.rot[k] + i, F.r[k]);
+}
+
+// evaluates Ops::Width configurations starting at index i
+template <class Ops>
+inline void ForwardKinematicsBlock(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t i)
+{
+    typedef typename Ops::V V;
+
+    V cBase, sBase, cShoulder, sShoulder, cElbow, sElbow, cWrist, sWrist, cTwist, sTwist, cF1, sF1, cF2, sF2;
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_BASE_SPIN] + i),   sBase, cBase);
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_SHOULDER] + i),    sShoulder, cShoulder);
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_ELBOW] + i),       sElbow, cElbow);
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_WRIST] + i),       sWrist, cWrist);
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_WRIST_TWIST] + i), sTwist, cTwist);
+
+    // base: T(x, 0, z) * Ry(spin)
+    V zero = Ops::Set(0.0f), one = Ops::Set(1.0f);
+    Frame<Ops> F;
+    F.r[0] = cBase;         F.r[1] = zero; F.r[2] = Ops::Neg(sBase);
+    F.r[3] = zero;          F.r[4] = one;  F.r[5] = zero;
+    F.r[6] = sBase;         F.r[7] = zero; F.r[8] = cBase;
+    F.t[0] = Ops::Load(in.dof[DOF_BASE_X] + i);
+    F.t[1] = zero;
+    F.t[2] = Ops::Load(in.dof[DOF_BASE_Z] + i);
+
+    Translate<Ops>(F, 1, Ops::Set(kShoulderHeight)); RotateZ<Ops>(F, cShoulder, sShoulder);
+    Translate<Ops>(F, 1, Ops::Set(kUpperArmLen));    RotateZ<Ops>(F, cElbow, sElbow);
+    Translate<Ops>(F, 1, Ops::Set(kForearmLen));     RotateZ<Ops>(F, cWrist, sWrist);
+    RotateY<Ops>(F, cTwist, sTwist);
+    Translate<Ops>(F, 1, Ops::Set(kPalmOffset));
+    StorePose<Ops>(out.palm, i, F);
+
+    if (!out.tip1.x && !out.tip2.x)
+        return;
+
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_FINGER1] + i), sF1, cF1);
+    SinCosDeg<Ops>(Ops::Load(in.dof[DOF_FINGER2] + i), sF2, cF2);
+
+    // second finger is mirrored: sin(-a) = -sin(a)
+    for (int f = 0; f < 2; ++f)
+    {
+        const PoseSoA& p = (f == 0) ? out.tip1 : out.tip2;
+        if (!p.x) continue;
+
+        Frame<Ops> T = F;
+        Translate<Ops>(T, 0, Ops::Set(f == 0 ? +kFingerSpread : -kFingerSpread));
+        RotateZ<Ops>(T, cF1, f == 0 ? sF1 : Ops::Neg(sF1));
+        Translate<Ops>(T, 1, Ops::Set(kFingerLen));
+        RotateZ<Ops>(T, cF2, f == 0 ? sF2 : Ops::Neg(sF2));
+        Translate<Ops>(T, 1, Ops::Set(kFingerTipLen));
+        StorePose<Ops>(p, i, T);
+    }
+}
+
+// runs every full block in [0, count) and returns how many configurations were done
+template <class Ops>
+inline size_t ForwardKinematicsBlocks(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count)
+{
+    size_t i = 0;
+    for (; i + Ops::Width <= count; i += Ops::Width)
+        ForwardKinematicsBlock<Ops>(in, out, i);
+    return i;
+}
+
+// per-ISA entry points (defined in batch_fk_sse.cpp / _avx2.cpp / _avx512.cpp)
+size_t ForwardKinematicsSSE(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count);
+size_t ForwardKinematicsAVX2(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count);
+size_t ForwardKinematicsAVX512(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count);
+
+} // namespace batchfk
+
+#endif
@@ -0,0 +1,49 @@
+#include <robotarm/batch_fk_kernel.h>
+
+#if defined(ROBOTARM_SIMD_X86)
+#include <emmintrin.h>
+
+namespace {
+
+// 4 lanes, SSE2 only
+struct SSEOps
+{
+    typedef __m128  V;
+    typedef __m128i I;
+    typedef __m128  M;
+    static const size_t Width = 4;
+
+    static V Set(float v)               { return _mm_set1_ps(v); }
+    static V Load(const float* p)       { return _mm_loadu_ps(p); }
+    static void Store(float* p, V v)    { _mm_storeu_ps(p, v); }
+    static V Add(V a, V b)              { return _mm_add_ps(a, b); }
+    static V Sub(V a, V b)              { return _mm_sub_ps(a, b); }
+    static V Mul(V a, V b)              { return _mm_mul_ps(a, b); }
+    static V Neg(V a)                   { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static I RoundToInt(V a)            { return _mm_cvtps_epi32(a); }
+    static V ToFloat(I a)               { return _mm_cvtepi32_ps(a); }
+    static I AddInt(I a, int b)         { return _mm_add_epi32(a, _mm_set1_epi32(b)); }
+    static M TestBit(I a, int bit)
+    {
+        __m128i b = _mm_set1_epi32(bit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, b), b));
+    }
+    static V Select(M m, V a, V b)      { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static V NegateIf(M m, V a)         { return _mm_xor_ps(a, _mm_and_ps(m, _mm_set1_ps(-0.0f))); }
+};
+
+} // namespace
+
+size_t batchfk::ForwardKinematicsSSE(const ArmJointsSoA& in, const ArmPosesSoA& out, size_t count)
+{
+    return ForwardKinematicsBlocks<SSEOps>(in, out, count);
+}
+
+#else
+
+size_t batchfk::ForwardKinematicsSSE(const ArmJointsSoA&, const ArmPosesSoA&, size_t)
+{
+    return 0;
+}
+
+#endif
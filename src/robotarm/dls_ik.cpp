@@ -0,0 +1,292 @@
+#include <robotarm/dls_ik.h>
+
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+const float kRadToDeg = 57.295779513082320876798154814105f;
+
+// solves A x = b in place for a small symmetric positive definite A (Cholesky)
+bool SolveSPD(float A[6][6], float b[6], int n)
+{
+    for (int j = 0; j < n; ++j)
+    {
+        float d = A[j][j];
+        for (int k = 0; k < j; ++k)
+            d -= A[j][k] * A[j][k];
+        if (d <= 0.0f)
+            return false;
+        A[j][j] = std::sqrt(d);
+        for (int i = j + 1; i < n; ++i)
+        {
+            float s = A[i][j];
+            for (int k = 0; k < j; ++k)
+                s -= A[i][k] * A[j][k];
+            A[i][j] = s / A[j][j];
+        }
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        for (int k = 0; k < i; ++k)
+            b[i] -= A[i][k] * b[k];
+        b[i] /= A[i][i];
+    }
+    for (int i = n - 1; i >= 0; --i)
+    {
+        for (int k = i + 1; k < n; ++k)
+            b[i] -= A[k][i] * b[k];
+        b[i] /= A[i][i];
+    }
+    return true;
+}
+
+} // namespace
+
+DLSIKSolver::DLSIKSolver(const KinematicChain& chain, int effector, float* const* dofs, int dofCount,
+                         const float* lo, const float* hi)
+    : work(chain), effector(effector), firstJoint((int)chain.Size()), dofCount(0)
+{
+    if (dofCount > kMaxDLSDofs)
+        dofCount = kMaxDLSDofs;
+    this->dofCount = dofCount;
+
+    for (int k = 0; k < dofCount; ++k)
+    {
+        this->dofs[k] = dofs[k];
+        q[k] = *dofs[k];
+        this->lo[k] = lo ? lo[k] : -1e30f;
+        this->hi[k] = hi ? hi[k] :  1e30f;
+        stepScale[k] = 1.0f;
+        wrap[k] = false;
+    }
+
+    // redirect every joint driven by a solved dof to the working copy
+    for (size_t j = 0; j < work.joints.size(); ++j)
+    {
+        for (int k = 0; k < dofCount; ++k)
+        {
+            if (work.joints[j].source != dofs[k])
+                continue;
+            work.joints[j].source = &q[k];
+            // revolute sources are degrees, the Jacobian works per radian
+            if (work.joints[j].type == JointType::Revolute)
+            {
+                stepScale[k] = kRadToDeg;
+                wrap[k] = this->hi[k] - this->lo[k] >= 360.0f;
+            }
+            if ((int)j < firstJoint)
+                firstJoint = (int)j;
+
+            // joints off the effector's path (e.g. fingers for the palm) do not move it
+            bool ancestor = false;
+            for (int a = effector; a >= 0; a = work.joints[a].parent)
+                if (a == (int)j) { ancestor = true; break; }
+            if (ancestor)
+                driven.push_back({ (int)j, k });
+        }
+    }
+}
+
+float DLSIKSolver::Error(const glm::mat4& target, const DLSIKOptions& options, float e[6], float& posErr, float& angErr) const
+{
+    const glm::mat4& M = work.World(effector);
+
+    glm::vec3 dp = glm::vec3(target[3]) - glm::vec3(M[3]);
+    // small-angle rotation taking the current axes onto the target axes
+    glm::vec3 dr = 0.5f * (glm::cross(glm::vec3(M[0]), glm::vec3(target[0])) +
+                           glm::cross(glm::vec3(M[1]), glm::vec3(target[1])) +
+                           glm::cross(glm::vec3(M[2]), glm::vec3(target[2])));
+
+    posErr = glm::length(dp);
+    angErr = glm::length(dr);
+
+    float w = options.orientationWeight;
+    e[0] = dp.x; e[1] = dp.y; e[2] = dp.z;
+    e[3] = w * dr.x; e[4] = w * dr.y; e[5] = w * dr.z;
+    return e[0] * e[0] + e[1] * e[1] + e[2] * e[2] + e[3] * e[3] + e[4] * e[4] + e[5] * e[5];
+}
+
+// geometric Jacobian per radian (revolute) / unit (prismatic), from the cached world frames
+void DLSIKSolver::Jacobian(float J[6][kMaxDLSDofs]) const
+{
+    for (int r = 0; r < 6; ++r)
+        for (int k = 0; k < dofCount; ++k)
+            J[r][k] = 0.0f;
+
+    glm::vec3 pe = glm::vec3(work.World(effector)[3]);
+    for (size_t d = 0; d < driven.size(); ++d)
+    {
+        const Joint& jt = work.joints[driven[d].joint];
+        const glm::mat4& W = work.World(driven[d].joint);
+        glm::vec3 axis = jt.sign * (glm::mat3(W) * jt.axis);
+        int k = driven[d].dof;
+
+        if (jt.type == JointType::Revolute)
+        {
+            glm::vec3 v = glm::cross(axis, pe - glm::vec3(W[3]));
+            J[0][k] += v.x;    J[1][k] += v.y;    J[2][k] += v.z;
+            J[3][k] += axis.x; J[4][k] += axis.y; J[5][k] += axis.z;
+        }
+        else if (jt.type == JointType::Prismatic)
+        {
+            J[0][k] += axis.x; J[1][k] += axis.y; J[2][k] += axis.z;
+        }
+    }
+}
+
+DLSIKResult DLSIKSolver::Solve(const glm::mat4& target, const DLSIKOptions& options)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    DLSIKResult result = { false, false, 0, 0.0f, 0.0f, 0.0f };
+    const int rows = (options.orientationWeight > 0.0f) ? 6 : 3;
+
+    // warm start from the live joint values; upstream joints (base) are refreshed too
+    for (int k = 0; k < dofCount; ++k)
+    {
+        q[k] = *dofs[k];
+        // e.g. BaseSpin wound past +-180 by the mouse: the same angle, inside the limits,
+        // instead of a joint pinned at (or clamped straight onto) a limit
+        if (wrap[k] && (q[k] < lo[k] || q[k] > hi[k]))
+        {
+            q[k] = lo[k] + std::fmod(q[k] - lo[k], 360.0f);
+            if (q[k] < lo[k])
+                q[k] += 360.0f;
+        }
+    }
+    work.Update();
+
+    float e[6], posErr, angErr;
+    float cost = Error(target, options, e, posErr, angErr);
+    float lambda = options.lambdaMin;
+    float qPrev[kMaxDLSDofs];
+
+    for (;;)
+    {
+        if (posErr <= options.positionTolerance && (rows == 3 || angErr <= options.angleTolerance))
+        {
+            result.converged = true;
+            break;
+        }
+        float elapsed = std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+        if (result.iterations >= options.maxIterations || elapsed >= options.maxTimeUs)
+        {
+            result.budgetExceeded = true;
+            break;
+        }
+        ++result.iterations;
+
+        float J[6][kMaxDLSDofs];
+        Jacobian(J);
+        for (int r = 3; r < rows; ++r)
+            for (int k = 0; k < dofCount; ++k)
+                J[r][k] *= options.orientationWeight;
+
+        // joints pinned at a limit and pushed further out are dropped from J and the
+        // step is solved again, otherwise clamping stalls the iteration
+        bool locked[kMaxDLSDofs] = {};
+        float dq[kMaxDLSDofs];
+        bool solved = false;
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            // A = J J^T
+            float A[6][6];
+            for (int r = 0; r < rows; ++r)
+                for (int c = 0; c <= r; ++c)
+                {
+                    float s = 0.0f;
+                    for (int k = 0; k < dofCount; ++k)
+                        if (!locked[k])
+                            s += J[r][k] * J[c][k];
+                    A[r][c] = A[c][r] = s;
+                }
+
+            // near a singularity the manipulability drops: raise the damping floor
+            // (position rows only; with orientation a 5-DOF J J^T is always rank deficient)
+            float lambdaFloor = options.lambdaMin;
+            if (rows == 3)
+            {
+                float det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+                          - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+                          + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+                float w = std::sqrt(std::fabs(det));
+                if (w < options.manipulabilityMin)
+                {
+                    float t = 1.0f - w / options.manipulabilityMin;
+                    lambdaFloor += (options.lambdaMax - options.lambdaMin) * t * t;
+                }
+            }
+            if (lambda < lambdaFloor)
+                lambda = lambdaFloor;
+
+            // dq = J^T (J J^T + lambda^2 I)^-1 e
+            float y[6];
+            for (int r = 0; r < rows; ++r)
+            {
+                A[r][r] += lambda * lambda;
+                y[r] = e[r];
+            }
+            solved = SolveSPD(A, y, rows);
+            if (!solved)
+                break;
+
+            bool newLock = false;
+            for (int k = 0; k < dofCount; ++k)
+            {
+                dq[k] = 0.0f;
+                if (locked[k])
+                    continue;
+                for (int r = 0; r < rows; ++r)
+                    dq[k] += J[r][k] * y[r];
+                if ((q[k] >= hi[k] && dq[k] > 0.0f) || (q[k] <= lo[k] && dq[k] < 0.0f))
+                    locked[k] = newLock = true;
+            }
+            if (!newLock)
+                break;
+        }
+        if (!solved)
+        {
+            lambda = options.lambdaMax;
+            continue;
+        }
+
+        for (int k = 0; k < dofCount; ++k)
+        {
+            qPrev[k] = q[k];
+            if (!locked[k])
+                q[k] = glm::clamp(q[k] + dq[k] * stepScale[k], lo[k], hi[k]);
+        }
+        work.UpdateFrom(firstJoint);
+
+        float eNew[6], posNew, angNew;
+        float costNew = Error(target, options, eNew, posNew, angNew);
+        if (costNew < cost)
+        {
+            // accepted: trust the linear model more
+            cost = costNew; posErr = posNew; angErr = angNew;
+            for (int r = 0; r < 6; ++r) e[r] = eNew[r];
+            lambda = glm::max(lambda * 0.5f, options.lambdaMin);
+        }
+        else
+        {
+            // rejected: roll back and damp harder
+            for (int k = 0; k < dofCount; ++k)
+                q[k] = qPrev[k];
+            work.UpdateFrom(firstJoint);
+            if (lambda >= options.lambdaMax)
+                break;  // stuck in a local minimum (e.g. target out of reach)
+            lambda = glm::min(lambda * 4.0f, options.lambdaMax);
+        }
+    }
+
+    // q only ever holds accepted steps, so it is never worse than the warm start
+    for (int k = 0; k < dofCount; ++k)
+        *dofs[k] = q[k];
+
+    result.positionError = posErr;
+    result.angleError = angErr;
+    result.elapsedUs = std::chrono::duration<float, std::micro>(Clock::now() - start).count();
+    return result;
+}
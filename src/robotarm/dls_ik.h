@@ -0,0 +1,73 @@
+#ifndef DLS_IK_H
+#define DLS_IK_H
+
+#include <robotarm/kinematic_chain.h>
+
+// ======================================================================
+// Iterative damped-least-squares (Levenberg-Marquardt) IK
+// ======================================================================
+//
+// For goals the closed-form solver (arm_ik.h) does not cover: position-only
+// targets, unreachable targets (gets as close as possible), other chains.
+// The geometric Jacobian is read straight from the chain's world frames.
+
+const int kMaxDLSDofs = 16;
+
+struct DLSIKOptions
+{
+    int   maxIterations     = 32;
+    float maxTimeUs         = 200.0f;   // wall-clock budget per Solve() call
+    float positionTolerance = 1e-4f;    // world units
+    float angleTolerance    = 1e-3f;    // radians, ignored when orientationWeight == 0
+    float orientationWeight = 0.0f;     // 0 = position-only goal
+    float lambdaMin         = 1e-3f;    // damping range (LM adapts within it)
+    float lambdaMax         = 1.0f;
+    float manipulabilityMin = 1e-3f;    // below this sqrt(det(J J^T)) damping is raised
+};
+
+struct DLSIKResult
+{
+    bool  converged;
+    bool  budgetExceeded;   // stopped by maxIterations / maxTimeUs
+    int   iterations;
+    float positionError;    // of the pose written back
+    float angleError;
+    float elapsedUs;
+};
+
+class DLSIKSolver
+{
+public:
+    // dofs point at the joint values to solve (e.g. &ShoulderAng); every chain joint
+    // driven by one of them takes part. lo/hi are per-dof limits (may be null).
+    DLSIKSolver(const KinematicChain& chain, int effector, float* const* dofs, int dofCount,
+                const float* lo = nullptr, const float* hi = nullptr);
+
+    // warm-starts from the current *dofs and writes the best pose found back into them
+    // (a full-turn revolute dof outside its limits is first wrapped by 360 degrees)
+    DLSIKResult Solve(const glm::mat4& target, const DLSIKOptions& options = DLSIKOptions());
+
+private:
+    struct Driven
+    {
+        int joint;
+        int dof;
+    };
+
+    KinematicChain work;            // copy of the chain, sources redirected to q
+    int            effector;
+    int            firstJoint;      // earliest joint touched by a dof
+    int            dofCount;
+    float*         dofs[kMaxDLSDofs];
+    float          q[kMaxDLSDofs];
+    float          lo[kMaxDLSDofs];
+    float          hi[kMaxDLSDofs];
+    float          stepScale[kMaxDLSDofs];   // J column units -> dof units: 180/pi revolute, 1 prismatic
+    bool           wrap[kMaxDLSDofs];        // revolute with a full turn of range: warm start wrapped into it
+    std::vector<Driven> driven;     // only joints that are ancestors of the effector
+
+    float Error(const glm::mat4& target, const DLSIKOptions& options, float e[6], float& posErr, float& angErr) const;
+    void  Jacobian(float J[6][kMaxDLSDofs]) const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef FAST_TRIG_H
+#define FAST_TRIG_H
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FAST_TRIG_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// ======================================================================
+// sin/cos of an angle in degrees without a libm call
+// ======================================================================
+//
+// Cody-Waite reduction to [-pi/4, pi/4] plus the cephes sinf/cosf polynomials
+// (~1 ulp for the joint angle ranges we see). The batch FK kernels use the same
+// constants in vector form (batch_fk_kernel.h).
+
+namespace fasttrig {
+
+constexpr float kDegToRad  = 0.01745329251994329576923690768489f;
+constexpr float kTwoOverPi = 0.63661977236758134308f;
+// pi/2 split in three parts so j * kPio2A is exact
+constexpr float kPio2A     = 1.5703125f;
+constexpr float kPio2B     = 4.837512969970703125e-4f;
+constexpr float kPio2C     = 7.54978995489188216e-8f;
+// minimax polynomials on [-pi/4, pi/4]
+constexpr float kSin0      = -1.9515295891e-4f;
+constexpr float kSin1      =  8.3321608736e-3f;
+constexpr float kSin2      = -1.6666654611e-1f;
+constexpr float kCos0      =  2.443315711809948e-5f;
+constexpr float kCos1      = -1.388731625493765e-3f;
+constexpr float kCos2      =  4.166664568298827e-2f;
+
+inline void SinCosRad(float x, float& s, float& c)
+{
+    float y = x * kTwoOverPi;
+    int q = (int)(y + (y >= 0.0f ? 0.5f : -0.5f));
+    float j = (float)q;
+
+    float r = x - j * kPio2A;
+    r = r - j * kPio2B;
+    r = r - j * kPio2C;
+    float z = r * r;
+
+    float ps = z * r * ((kSin0 * z + kSin1) * z + kSin2) + r;
+    float pc = ((kCos0 * z + kCos1) * z + kCos2) * (z * z) - 0.5f * z + 1.0f;
+
+    // quadrant: 1,3 swap sin/cos; sin < 0 in 2,3; cos < 0 in 1,2
+    float sq = (q & 1) ? pc : ps;
+    float cq = (q & 1) ? ps : pc;
+    s = (q & 2) ? -sq : sq;
+    c = ((q + 1) & 2) ? -cq : cq;
+}
+
+inline void SinCosDeg(float deg, float& s, float& c)
+{
+    SinCosRad(deg * kDegToRad, s, c);
+}
+
+// 4 angles at once (SSE2 when available)
+inline void SinCosDeg4(const float* deg, float* s, float* c)
+{
+#if defined(FAST_TRIG_SSE2)
+    __m128 x = _mm_mul_ps(_mm_loadu_ps(deg), _mm_set1_ps(kDegToRad));
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(kTwoOverPi)));
+    __m128 j = _mm_cvtepi32_ps(q);
+
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(kPio2A)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(kPio2B)));
+    r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(kPio2C)));
+    __m128 z = _mm_mul_ps(r, r);
+
+    __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(z, r),
+        _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(kSin0), z), _mm_set1_ps(kSin1)), z), _mm_set1_ps(kSin2))), r);
+    __m128 pc = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(kCos0), z), _mm_set1_ps(kCos1)), z), _mm_set1_ps(kCos2)), _mm_mul_ps(z, z));
+    pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+    __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2);
+    __m128 swap   = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sinNeg = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cosNeg = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+
+    __m128 sq = _mm_or_ps(_mm_and_ps(swap, pc), _mm_andnot_ps(swap, ps));
+    __m128 cq = _mm_or_ps(_mm_and_ps(swap, ps), _mm_andnot_ps(swap, pc));
+    _mm_storeu_ps(s, _mm_xor_ps(sq, sinNeg));
+    _mm_storeu_ps(c, _mm_xor_ps(cq, cosNeg));
+#else
+    for (int i = 0; i < 4; ++i)
+        SinCosDeg(deg[i], s[i], c[i]);
+#endif
+}
+
+} // namespace fasttrig
+
+#endif
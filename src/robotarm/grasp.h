@@ -0,0 +1,38 @@
+#ifndef GRASP_H
+#define GRASP_H
+
+#include <robotarm/robot_arm.h>
+
+#include <cmath>
+
+// ======================================================================
+// Grasp test (shared by RobotArm and the headless tools)
+// ======================================================================
+
+// ---- grasp test parameters (may be tuned slightly) ----
+const float kGrabDist  = 0.35f; // allowed palm-object centre distance (generous for the model scale)
+const float kMinClose1 = 10.0f; // finger1 >= 10 deg counts as closed
+const float kMinClose2 = 20.0f; // |finger2| >= 20 deg counts as closed
+
+// palm world transform, refreshing the chain first if a joint moved
+inline const glm::mat4& PalmMatrix(KinematicChain& chain)
+{
+    UpdateRobotArmChain(chain);
+    return chain.World(LINK_PALM);
+}
+
+inline bool FingersClosed(float finger1, float finger2)
+{
+    return (finger1 >= kMinClose1) && (std::abs(finger2) >= kMinClose2);
+}
+
+// fingers closed enough and the palm close enough to the object centre
+inline bool CanGrasp(KinematicChain& chain, float finger1, float finger2, const glm::vec3& objectPos)
+{
+    if (!FingersClosed(finger1, finger2))
+        return false;
+    glm::vec3 palmPos = glm::vec3(PalmMatrix(chain)[3]);
+    return glm::length(palmPos - objectPos) <= kGrabDist;
+}
+
+#endif
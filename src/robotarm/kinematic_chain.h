@@ -0,0 +1,173 @@
+#ifndef KINEMATIC_CHAIN_H
+#define KINEMATIC_CHAIN_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <robotarm/rigid_transform.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+enum class JointType
+{
+    Fixed,      // offset only
+    Revolute,   // rotate about axis by source (degrees)
+    Prismatic   // slide along axis by source (world units)
+};
+
+// One row of the joint table. Local transform = T(offset) * Motion(axis, sign * *source).
+struct Joint
+{
+    const char*  name;
+    int          parent;   // index of the parent joint, -1 = world
+    glm::vec3    offset;   // fixed translation in the parent frame
+    glm::vec3    axis;     // joint axis in the local frame
+    JointType    type;
+    const float* source;   // angle/position source (e.g. &ShoulderAng), unused for Fixed
+    float        sign;     // mirrored links (second finger) use -1
+};
+
+// Flat kinematic tree. Joints are stored parent-before-child so a single forward
+// pass fills the world transforms into one contiguous array.
+//
+// Joint state is cached in value[] with a dirty flag per joint: Sync() pulls the
+// sources and flags the joints that moved, UpdateDirty() recomputes only those and
+// their descendants. version counts world[] changes so callers can skip work too.
+//
+// Transform is glm::mat4 (KinematicChain, what the renderer and IK use) or
+// RigidTransform (RigidKinematicChain: half the memory per link, ToMat4() at the
+// render boundary).
+template <class Transform>
+class BasicKinematicChain
+{
+public:
+    std::vector<Joint>         joints;
+    std::vector<Transform>     world;
+    std::vector<float>         value;   // joint values world[] was computed from
+    std::vector<unsigned char> dirty;   // value changed since world[] was computed
+    uint64_t                   version = 0;
+
+    void Clear()
+    {
+        joints.clear();
+        world.clear();
+        value.clear();
+        dirty.clear();
+        ++version;
+    }
+
+    int AddJoint(const char* name, int parent, glm::vec3 offset, glm::vec3 axis,
+                 JointType type, const float* source = nullptr, float sign = 1.0f)
+    {
+        // parent must already exist, otherwise Update() would read an unset matrix
+        if (parent >= (int)joints.size())
+            parent = -1;
+        joints.push_back({ name, parent, offset, axis, type, source, sign });
+        world.push_back(ChainIdentity<Transform>());
+        value.push_back(source ? *source : 0.0f);
+        dirty.push_back(1);
+        return (int)joints.size() - 1;
+    }
+
+    // set a joint value directly (joints without a source, or bypassing it)
+    void SetValue(int i, float v)
+    {
+        if (value[i] != v)
+        {
+            value[i] = v;
+            dirty[i] = 1;
+        }
+    }
+
+    // pull every source into value[]; true if any joint is dirty afterwards
+    bool Sync()
+    {
+        bool any = false;
+        for (size_t i = 0; i < joints.size(); ++i)
+        {
+            const float* src = joints[i].source;
+            float v = src ? *src : value[i];
+            dirty[i] |= (unsigned char)(v != value[i]);
+            value[i] = v;
+            any |= (dirty[i] != 0);
+        }
+        return any;
+    }
+
+    // world[] now matches value[] (after an external evaluator wrote it)
+    void MarkClean()
+    {
+        std::fill(dirty.begin(), dirty.end(), (unsigned char)0);
+        ++version;
+    }
+
+    // recompute only joints that moved and their descendants; false = nothing to do
+    bool UpdateDirty()
+    {
+        if (!Sync())
+            return false;
+        for (size_t i = 0; i < joints.size(); ++i)
+        {
+            // parent-before-child: a stale parent has already been flagged this pass
+            int p = joints[i].parent;
+            if (p >= 0 && dirty[p])
+                dirty[i] = 1;
+            if (dirty[i])
+                Recompute(i);
+        }
+        MarkClean();
+        return true;
+    }
+
+    // recompute every link world transform
+    void Update()
+    {
+        UpdateFrom(0);
+    }
+
+    // recompute joints [first, end): joints before first are upstream or unrelated,
+    // so their cached transforms are still valid
+    void UpdateFrom(int first)
+    {
+        for (size_t i = (size_t)first; i < joints.size(); ++i)
+        {
+            if (joints[i].source)
+                value[i] = *joints[i].source;
+            dirty[i] = 0;
+            Recompute(i);
+        }
+        ++version;
+    }
+
+    const Transform& World(int i) const { return world[i]; }
+    size_t Size() const { return joints.size(); }
+
+private:
+    void Recompute(size_t i)
+    {
+        const Joint& j = joints[i];
+        Transform M = (j.parent < 0) ? ChainIdentity<Transform>() : world[j.parent];
+
+        switch (j.type)
+        {
+        case JointType::Fixed:
+            M = ChainTranslate(M, j.offset);
+            break;
+        case JointType::Revolute:
+            M = ChainTranslate(M, j.offset);
+            M = ChainRotate(M, glm::radians(j.sign * value[i]), j.axis);
+            break;
+        case JointType::Prismatic:
+            M = ChainTranslate(M, j.offset + j.axis * (j.sign * value[i]));
+            break;
+        }
+        world[i] = M;
+    }
+};
+
+typedef BasicKinematicChain<glm::mat4>      KinematicChain;
+typedef BasicKinematicChain<RigidTransform> RigidKinematicChain;
+
+#endif
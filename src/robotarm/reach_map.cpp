@@ -0,0 +1,218 @@
+#include <robotarm/reach_map.h>
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+void ArmGeometry(float g[4])
+{
+    g[0] = kShoulderHeight;
+    g[1] = kUpperArmLen;
+    g[2] = kForearmLen;
+    g[3] = kPalmOffset;
+}
+
+} // namespace
+
+float PalmManipulability(const KinematicChain& chain)
+{
+    // joints that move the palm position (wrist twist is along the palm axis: no lever)
+    static const int kLinks[] = { LINK_BASE, LINK_SHOULDER, LINK_ELBOW, LINK_WRIST_BEND };
+
+    glm::vec3 p = glm::vec3(chain.World(LINK_PALM)[3]);
+    glm::vec3 J[4];
+    for (int k = 0; k < 4; ++k)
+    {
+        const Joint& jt = chain.joints[kLinks[k]];
+        const glm::mat4& W = chain.World(kLinks[k]);
+        glm::vec3 axis = glm::mat3(W) * jt.axis;
+        J[k] = glm::cross(axis, p - glm::vec3(W[3]));
+    }
+
+    // A = J J^T (3x3), manipulability = sqrt(det A)
+    float A[3][3];
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+        {
+            float s = 0.0f;
+            for (int k = 0; k < 4; ++k)
+                s += J[k][r] * J[k][c];
+            A[r][c] = s;
+        }
+    float det = A[0][0] * (A[1][1] * A[2][2] - A[1][2] * A[2][1])
+              - A[0][1] * (A[1][0] * A[2][2] - A[1][2] * A[2][0])
+              + A[0][2] * (A[1][0] * A[2][1] - A[1][1] * A[2][0]);
+    return std::sqrt(glm::max(det, 0.0f));
+}
+
+bool BuildReachMap(const char* path, const ReachMapBuildOptions& options)
+{
+    // palm stays within this distance of the shoulder
+    const float reach = kUpperArmLen + kForearmLen + kPalmOffset + options.voxelSize;
+    const uint32_t n = (uint32_t)std::ceil(2.0f * reach / options.voxelSize);
+
+    ReachMapHeader header = {};
+    header.magic      = kReachMapMagic;
+    header.version    = kReachMapVersion;
+    header.headerSize = sizeof(ReachMapHeader);
+    header.cellSize   = sizeof(ReachCell);
+    header.dims[0] = header.dims[1] = header.dims[2] = n;
+    header.origin[0]  = -reach;
+    header.origin[1]  = kShoulderHeight - reach;
+    header.origin[2]  = -reach;
+    header.voxelSize  = options.voxelSize;
+    ArmGeometry(header.geometry);
+    header.cellCount  = (uint64_t)n * n * n;
+    header.samples    = options.samples;
+
+    std::vector<ReachCell> cells((size_t)header.cellCount);
+    for (size_t i = 0; i < cells.size(); ++i)
+        cells[i] = ReachCell();
+
+    // chain driven by q; base translation stays at the origin
+    float q[ARM_DOF] = {};
+    const float* src[ARM_DOF];
+    for (int d = 0; d < ARM_DOF; ++d)
+        src[d] = &q[d];
+    KinematicChain chain;
+    BuildRobotArmChain(chain, src);
+
+    std::mt19937 rng(options.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    for (uint64_t s = 0; s < options.samples; ++s)
+    {
+        for (int j = 0; j < IK_DOF; ++j)
+        {
+            int dof = DOF_BASE_SPIN + j;
+            q[dof] = options.limits.lo[dof] + unit(rng) * (options.limits.hi[dof] - options.limits.lo[dof]);
+        }
+        UpdateRobotArmChain(chain);
+
+        const glm::mat4& palm = chain.World(LINK_PALM);
+        float fx = (palm[3].x - header.origin[0]) / header.voxelSize;
+        float fy = (palm[3].y - header.origin[1]) / header.voxelSize;
+        float fz = (palm[3].z - header.origin[2]) / header.voxelSize;
+        if (fx < 0.0f || fy < 0.0f || fz < 0.0f || fx >= n || fy >= n || fz >= n)
+            continue;
+        ReachCell* cell = &cells[((size_t)(uint32_t)fz * n + (uint32_t)fy) * n + (uint32_t)fx];
+
+        float w = PalmManipulability(chain);
+        if (cell->samples == 0 || w > cell->manipulability)
+        {
+            cell->manipulability = w;
+            for (int j = 0; j < IK_DOF; ++j)
+                cell->seed[j] = q[DOF_BASE_SPIN + j];
+        }
+        ++cell->samples;
+    }
+
+    FILE* fp = std::fopen(path, "wb");
+    if (!fp)
+    {
+        std::cout << "ERROR::REACH_MAP::cannot write " << path << std::endl;
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, fp) == 1 &&
+              std::fwrite(cells.data(), sizeof(ReachCell), cells.size(), fp) == cells.size();
+    ok = (std::fclose(fp) == 0) && ok;
+    if (!ok)
+        std::cout << "ERROR::REACH_MAP::short write to " << path << std::endl;
+    return ok;
+}
+
+bool ReachMap::Open(const char* path)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER len;
+    GetFileSizeEx(f, &len);
+    HANDLE m = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* v = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!v)
+    {
+        if (m) CloseHandle(m);
+        CloseHandle(f);
+        return false;
+    }
+    file = f;
+    mapping = m;
+    view = v;
+    size = (size_t)len.QuadPart;
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ReachMapHeader))
+    {
+        ::close(fd);
+        return false;
+    }
+    void* v = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);    // the mapping keeps the file alive
+    if (v == MAP_FAILED)
+        return false;
+    view = v;
+    size = (size_t)st.st_size;
+#endif
+
+    const ReachMapHeader* h = static_cast<const ReachMapHeader*>(view);
+    float g[4];
+    ArmGeometry(g);
+    bool valid = size >= sizeof(ReachMapHeader) &&
+                 h->magic == kReachMapMagic &&
+                 h->version == kReachMapVersion &&
+                 h->headerSize == sizeof(ReachMapHeader) &&
+                 h->cellSize == sizeof(ReachCell) &&
+                 h->cellCount == (uint64_t)h->dims[0] * h->dims[1] * h->dims[2] &&
+                 size >= sizeof(ReachMapHeader) + h->cellCount * sizeof(ReachCell) &&
+                 h->voxelSize > 0.0f;
+    for (int i = 0; valid && i < 4; ++i)
+        valid = (h->geometry[i] == g[i]);
+    if (!valid)
+    {
+        std::cout << "ERROR::REACH_MAP::" << path << " is not a reach map for this arm (rebuild it)" << std::endl;
+        Close();
+        return false;
+    }
+
+    header = h;
+    cells = reinterpret_cast<const ReachCell*>(static_cast<const char*>(view) + sizeof(ReachMapHeader));
+    return true;
+}
+
+void ReachMap::Close()
+{
+#if defined(_WIN32)
+    if (view) UnmapViewOfFile(view);
+    if (mapping) CloseHandle((HANDLE)mapping);
+    if (file) CloseHandle((HANDLE)file);
+    file = mapping = nullptr;
+#else
+    if (view) munmap(view, size);
+#endif
+    view = nullptr;
+    size = 0;
+    header = nullptr;
+    cells = nullptr;
+}
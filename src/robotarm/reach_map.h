@@ -0,0 +1,135 @@
+#ifndef REACH_MAP_H
+#define REACH_MAP_H
+
+#include <robotarm/arm_ik.h>
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ======================================================================
+// Precomputed reachability voxel map
+// ======================================================================
+//
+// Offline: BuildReachMap() samples the FK chain over the joint limits and bins the
+// palm position into a voxel grid (base-local: base translation removed, base spin
+// is one of the sampled joints). Each cell keeps how often it was hit, the best
+// manipulability seen and the joint angles of that sample as an IK seed.
+//
+// Runtime: ReachMap::Open() maps the file read-only; Lookup() is a bounds check and
+// an index computation, no load step.
+//
+// File: ReachMapHeader followed by dims[0] * dims[1] * dims[2] ReachCell, x fastest.
+
+const uint32_t kReachMapMagic   = 0x4d524152;    // "RARM"
+const uint32_t kReachMapVersion = 1;
+
+struct ReachMapHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;    // sizeof(ReachMapHeader) at build time
+    uint32_t cellSize;      // sizeof(ReachCell) at build time
+    uint32_t dims[3];
+    uint32_t reserved;
+    float    origin[3];     // min corner, base-local
+    float    voxelSize;
+    float    geometry[4];   // kShoulderHeight, kUpperArmLen, kForearmLen, kPalmOffset
+    uint64_t cellCount;
+    uint64_t samples;       // FK samples used to build the map
+};
+
+struct ReachCell
+{
+    uint32_t samples;           // 0 = never reached
+    float    manipulability;    // best sqrt(det(J J^T)) of the palm position Jacobian
+    float    seed[IK_DOF];      // joint angles (degrees) of that best sample
+};
+
+static_assert(sizeof(ReachMapHeader) == 80, "ReachMapHeader layout is part of the file format");
+static_assert(sizeof(ReachCell) == 28, "ReachCell layout is part of the file format");
+
+struct ReachMapBuildOptions
+{
+    float          voxelSize = 0.04f;
+    uint64_t       samples   = 20000000;
+    unsigned       seed      = 1;
+    ArmJointLimits limits    = DefaultArmJointLimits();
+};
+
+// samples the arm and writes the map; false (with a message on stdout) on I/O errors
+bool BuildReachMap(const char* path, const ReachMapBuildOptions& options);
+
+// palm position Jacobian manipulability for a chain built by BuildRobotArmChain()
+float PalmManipulability(const KinematicChain& chain);
+
+class ReachMap
+{
+public:
+    ReachMap() {}
+    ~ReachMap() { Close(); }
+    ReachMap(const ReachMap&) = delete;
+    ReachMap& operator=(const ReachMap&) = delete;
+
+    // maps the file; rejects wrong magic/version/geometry or a truncated file
+    bool Open(const char* path);
+    void Close();
+    bool IsOpen() const { return header != nullptr; }
+
+    // cell containing a base-local palm position, nullptr outside the grid
+    const ReachCell* Lookup(const glm::vec3& p) const
+    {
+        float fx = (p.x - header->origin[0]) / header->voxelSize;
+        float fy = (p.y - header->origin[1]) / header->voxelSize;
+        float fz = (p.z - header->origin[2]) / header->voxelSize;
+        if (fx < 0.0f || fy < 0.0f || fz < 0.0f)
+            return nullptr;
+        uint32_t ix = (uint32_t)fx, iy = (uint32_t)fy, iz = (uint32_t)fz;
+        if (ix >= header->dims[0] || iy >= header->dims[1] || iz >= header->dims[2])
+            return nullptr;
+        return cells + ((size_t)iz * header->dims[1] + iy) * header->dims[0] + ix;
+    }
+
+    bool Reachable(const glm::vec3& p) const
+    {
+        const ReachCell* cell = Lookup(p);
+        return cell && cell->samples > 0;
+    }
+
+    // IK seed for p: the sampled cell with the best manipulability among the one
+    // containing p and its 26 neighbours (the map is Monte Carlo, so a reachable
+    // cell near the boundary may have no samples of its own); nullptr if all empty
+    const ReachCell* Seed(const glm::vec3& p) const
+    {
+        int ix = (int)std::floor((p.x - header->origin[0]) / header->voxelSize);
+        int iy = (int)std::floor((p.y - header->origin[1]) / header->voxelSize);
+        int iz = (int)std::floor((p.z - header->origin[2]) / header->voxelSize);
+        const ReachCell* best = nullptr;
+        for (int z = iz - 1; z <= iz + 1; ++z)
+            for (int y = iy - 1; y <= iy + 1; ++y)
+                for (int x = ix - 1; x <= ix + 1; ++x)
+                {
+                    if (x < 0 || y < 0 || z < 0 ||
+                        x >= (int)header->dims[0] || y >= (int)header->dims[1] || z >= (int)header->dims[2])
+                        continue;
+                    const ReachCell* c = cells + ((size_t)z * header->dims[1] + y) * header->dims[0] + x;
+                    if (c->samples > 0 && (!best || c->manipulability > best->manipulability))
+                        best = c;
+                }
+        return best;
+    }
+
+    const ReachMapHeader& Header() const { return *header; }
+
+private:
+    const ReachMapHeader* header = nullptr;
+    const ReachCell*      cells  = nullptr;
+    void*                 view   = nullptr;
+    size_t                size   = 0;
+#if defined(_WIN32)
+    void*                 file    = nullptr;
+    void*                 mapping = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef RIGID_TRANSFORM_H
+#define RIGID_TRANSFORM_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+
+// ======================================================================
+// Compact rigid transform: unit quaternion + translation
+// ======================================================================
+//
+// 28 bytes instead of a 64-byte mat4, and composing two of them is
+// 16 (rotation) + 15 (rotate the translation) multiplies instead of 64.
+// The rotation stays a rotation: float error only shows up as |q| drifting from 1,
+// which ToMat4() divides out, never as shear or scale.
+//
+// Semantics match the column-major mat4 it replaces: Apply(p) = R * p + t,
+// and Compose(A, B) == A * B.
+
+struct RigidTransform
+{
+    glm::vec3 t;        // translation
+    float     qx, qy, qz, qw;
+
+    static RigidTransform Identity()
+    {
+        RigidTransform T;
+        T.t = glm::vec3(0.0f);
+        T.qx = T.qy = T.qz = 0.0f;
+        T.qw = 1.0f;
+        return T;
+    }
+
+    // axis must be unit length
+    static RigidTransform FromAxisAngle(const glm::vec3& axis, float radians)
+    {
+        float h = 0.5f * radians;
+        float s = std::sin(h);
+        RigidTransform T;
+        T.t = glm::vec3(0.0f);
+        T.qx = axis.x * s;
+        T.qy = axis.y * s;
+        T.qz = axis.z * s;
+        T.qw = std::cos(h);
+        return T;
+    }
+
+    // R * v
+    glm::vec3 Rotate(const glm::vec3& v) const
+    {
+        // v + w * (2 u x v) + u x (2 u x v), u = (qx, qy, qz)
+        glm::vec3 u(qx, qy, qz);
+        glm::vec3 c = 2.0f * glm::cross(u, v);
+        return v + qw * c + glm::cross(u, c);
+    }
+
+    glm::vec3 Apply(const glm::vec3& p) const { return Rotate(p) + t; }
+
+    // rescale q to unit length (after long chains of compositions)
+    void Normalize()
+    {
+        float inv = 1.0f / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+        qx *= inv; qy *= inv; qz *= inv; qw *= inv;
+    }
+
+    glm::mat4 ToMat4() const
+    {
+        // s = 2 / |q|^2 keeps the result orthonormal even if q drifted
+        float s = 2.0f / (qx * qx + qy * qy + qz * qz + qw * qw);
+        float xx = qx * qx * s, yy = qy * qy * s, zz = qz * qz * s;
+        float xy = qx * qy * s, xz = qx * qz * s, yz = qy * qz * s;
+        float wx = qw * qx * s, wy = qw * qy * s, wz = qw * qz * s;
+
+        glm::mat4 M(1.0f);
+        M[0] = glm::vec4(1.0f - yy - zz, xy + wz, xz - wy, 0.0f);
+        M[1] = glm::vec4(xy - wz, 1.0f - xx - zz, yz + wx, 0.0f);
+        M[2] = glm::vec4(xz + wy, yz - wx, 1.0f - xx - yy, 0.0f);
+        M[3] = glm::vec4(t, 1.0f);
+        return M;
+    }
+};
+
+// A * B
+inline RigidTransform Compose(const RigidTransform& A, const RigidTransform& B)
+{
+    RigidTransform C;
+    C.qw = A.qw * B.qw - A.qx * B.qx - A.qy * B.qy - A.qz * B.qz;
+    C.qx = A.qw * B.qx + A.qx * B.qw + A.qy * B.qz - A.qz * B.qy;
+    C.qy = A.qw * B.qy - A.qx * B.qz + A.qy * B.qw + A.qz * B.qx;
+    C.qz = A.qw * B.qz + A.qx * B.qy - A.qy * B.qx + A.qz * B.qw;
+    C.t  = A.Apply(B.t);
+    return C;
+}
+
+inline RigidTransform Inverse(const RigidTransform& A)
+{
+    RigidTransform I;
+    I.qx = -A.qx; I.qy = -A.qy; I.qz = -A.qz; I.qw = A.qw;
+    I.t = -I.Rotate(A.t);
+    return I;
+}
+
+// ----------------------------------------------------------------------
+// Chain link operations, overloaded for both transform types so
+// BasicKinematicChain<T> reads the same for mat4 and RigidTransform.
+// ----------------------------------------------------------------------
+
+template <class T> inline T ChainIdentity();
+template <> inline glm::mat4 ChainIdentity<glm::mat4>() { return glm::mat4(1.0f); }
+template <> inline RigidTransform ChainIdentity<RigidTransform>() { return RigidTransform::Identity(); }
+
+// M * T(offset)
+inline glm::mat4 ChainTranslate(const glm::mat4& M, const glm::vec3& offset)
+{
+    return glm::translate(M, offset);
+}
+
+inline RigidTransform ChainTranslate(const RigidTransform& M, const glm::vec3& offset)
+{
+    RigidTransform R = M;
+    R.t = M.Apply(offset);
+    return R;
+}
+
+// M * R(axis, radians)
+inline glm::mat4 ChainRotate(const glm::mat4& M, float radians, const glm::vec3& axis)
+{
+    return glm::rotate(M, radians, axis);
+}
+
+inline RigidTransform ChainRotate(const RigidTransform& M, float radians, const glm::vec3& axis)
+{
+    // pure rotation: translation unchanged, only the quaternion product
+    RigidTransform B = RigidTransform::FromAxisAngle(glm::normalize(axis), radians);
+    RigidTransform R;
+    R.t  = M.t;
+    R.qw = M.qw * B.qw - M.qx * B.qx - M.qy * B.qy - M.qz * B.qz;
+    R.qx = M.qw * B.qx + M.qx * B.qw + M.qy * B.qz - M.qz * B.qy;
+    R.qy = M.qw * B.qy - M.qx * B.qz + M.qy * B.qw + M.qz * B.qx;
+    R.qz = M.qw * B.qz + M.qx * B.qy - M.qy * B.qx + M.qz * B.qw;
+    return R;
+}
+
+// render boundary: the GL side always takes a mat4
+inline const glm::mat4& ToMat4(const glm::mat4& M) { return M; }
+inline glm::mat4 ToMat4(const RigidTransform& M) { return M.ToMat4(); }
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef ROBOT_ARM_H
+#define ROBOT_ARM_H
+
+#include <robotarm/kinematic_chain.h>
+#include <robotarm/static_chain.h>
+
+// ======================================================================
+// Robot arm geometry: the single source of truth for link offsets.
+// ======================================================================
+
+constexpr float kShoulderHeight = 0.40f; // base  -> shoulder
+constexpr float kUpperArmLen    = 0.50f; // shoulder -> elbow
+constexpr float kForearmLen     = 0.50f; // elbow -> wrist
+constexpr float kPalmOffset     = 0.10f; // wrist -> palm
+constexpr float kFingerSpread   = 0.06f; // palm  -> finger base (+/- X)
+constexpr float kFingerLen      = 0.35f; // finger base -> finger tip
+constexpr float kFingerTipLen   = 0.225f; // finger tip joint -> cone apex (see DrawFingerTip)
+
+// user-controlled degrees of freedom, in the order of the controls (1~5)
+enum ArmDof
+{
+    DOF_BASE_X,
+    DOF_BASE_Z,
+    DOF_BASE_SPIN,
+    DOF_SHOULDER,
+    DOF_ELBOW,
+    DOF_WRIST,
+    DOF_WRIST_TWIST,
+    DOF_FINGER1,
+    DOF_FINGER2,
+    ARM_DOF
+};
+
+// joint limits (degrees / world units), used by the IK solvers
+struct ArmJointLimits
+{
+    float lo[ARM_DOF];
+    float hi[ARM_DOF];
+};
+
+inline ArmJointLimits DefaultArmJointLimits()
+{
+    ArmJointLimits L = { {
+        -2.0f, -2.0f, -180.0f,   // base x, z, spin
+        -150.0f, -160.0f,        // shoulder, elbow
+        -150.0f, -180.0f,        // wrist bend, twist
+        -90.0f, -180.0f          // fingers
+    }, {
+        2.0f, 2.0f, 180.0f,
+        150.0f, 160.0f,
+        150.0f, 180.0f,
+        90.0f, 180.0f
+    } };
+    return L;
+}
+
+// link indices inside the chain built by BuildRobotArmChain()
+enum ArmLink
+{
+    LINK_BASE_X,
+    LINK_BASE_Z,
+    LINK_BASE,          // after base spin (Y)
+    LINK_SHOULDER,      // Z
+    LINK_ELBOW,         // Z
+    LINK_WRIST_BEND,    // Z
+    LINK_WRIST,         // after wrist twist (Y)
+    LINK_PALM,
+    LINK_FINGER1,
+    LINK_FINGER1_TIP,
+    LINK_FINGER2,
+    LINK_FINGER2_TIP,
+    ARM_LINK_COUNT
+};
+
+// Base -> Shoulder -> Elbow -> Wrist -> Palm -> Fingers
+template <class Transform>
+inline void BuildRobotArmChain(BasicKinematicChain<Transform>& chain, const float* const src[ARM_DOF])
+{
+    const glm::vec3 X(1.0f, 0.0f, 0.0f), Y(0.0f, 1.0f, 0.0f), Z(0.0f, 0.0f, 1.0f);
+    const glm::vec3 O(0.0f);
+
+    chain.Clear();
+
+    int baseX    = chain.AddJoint("BaseX",      -1,       O, X, JointType::Prismatic, src[DOF_BASE_X]);
+    int baseZ    = chain.AddJoint("BaseZ",      baseX,    O, Z, JointType::Prismatic, src[DOF_BASE_Z]);
+    int base     = chain.AddJoint("Base",       baseZ,    O, Y, JointType::Revolute,  src[DOF_BASE_SPIN]);
+    int shoulder = chain.AddJoint("Shoulder",   base,     glm::vec3(0.0f, kShoulderHeight, 0.0f), Z, JointType::Revolute, src[DOF_SHOULDER]);
+    int elbow    = chain.AddJoint("Elbow",      shoulder, glm::vec3(0.0f, kUpperArmLen, 0.0f),    Z, JointType::Revolute, src[DOF_ELBOW]);
+    int bend     = chain.AddJoint("WristBend",  elbow,    glm::vec3(0.0f, kForearmLen, 0.0f),     Z, JointType::Revolute, src[DOF_WRIST]);
+    int wrist    = chain.AddJoint("Wrist",      bend,     O, Y, JointType::Revolute, src[DOF_WRIST_TWIST]);
+    int palm     = chain.AddJoint("Palm",       wrist,    glm::vec3(0.0f, kPalmOffset, 0.0f), O, JointType::Fixed);
+
+    // two fingers, mirrored about the palm
+    int f1 = chain.AddJoint("Finger1",    palm, glm::vec3(+kFingerSpread, 0.0f, 0.0f), Z, JointType::Revolute, src[DOF_FINGER1]);
+    chain.AddJoint("Finger1Tip",          f1,   glm::vec3(0.0f, kFingerLen, 0.0f),      Z, JointType::Revolute, src[DOF_FINGER2]);
+    int f2 = chain.AddJoint("Finger2",    palm, glm::vec3(-kFingerSpread, 0.0f, 0.0f), Z, JointType::Revolute, src[DOF_FINGER1], -1.0f);
+    chain.AddJoint("Finger2Tip",          f2,   glm::vec3(0.0f, kFingerLen, 0.0f),      Z, JointType::Revolute, src[DOF_FINGER2], -1.0f);
+}
+
+// same layout as BuildRobotArmChain(), specialised at compile time (index = ArmLink)
+constexpr Offset3 kShoulderOffset = { 0.0f, kShoulderHeight, 0.0f };
+constexpr Offset3 kElbowOffset    = { 0.0f, kUpperArmLen, 0.0f };
+constexpr Offset3 kWristOffset    = { 0.0f, kForearmLen, 0.0f };
+constexpr Offset3 kPalmOffset3    = { 0.0f, kPalmOffset, 0.0f };
+constexpr Offset3 kFinger1Offset  = { +kFingerSpread, 0.0f, 0.0f };
+constexpr Offset3 kFinger2Offset  = { -kFingerSpread, 0.0f, 0.0f };
+constexpr Offset3 kFingerTipOffset = { 0.0f, kFingerLen, 0.0f };
+
+typedef StaticChain<
+    PrismaticLink<-1,               Axis::X>,                           // LINK_BASE_X
+    PrismaticLink<LINK_BASE_X,      Axis::Z>,                           // LINK_BASE_Z
+    RevoluteLink <LINK_BASE_Z,      Axis::Y>,                           // LINK_BASE
+    RevoluteLink <LINK_BASE,        Axis::Z, kShoulderOffset>,          // LINK_SHOULDER
+    RevoluteLink <LINK_SHOULDER,    Axis::Z, kElbowOffset>,             // LINK_ELBOW
+    RevoluteLink <LINK_ELBOW,       Axis::Z, kWristOffset>,             // LINK_WRIST_BEND
+    RevoluteLink <LINK_WRIST_BEND,  Axis::Y>,                           // LINK_WRIST
+    FixedLink    <LINK_WRIST,       kPalmOffset3>,                      // LINK_PALM
+    RevoluteLink <LINK_PALM,        Axis::Z, kFinger1Offset>,           // LINK_FINGER1
+    RevoluteLink <LINK_FINGER1,     Axis::Z, kFingerTipOffset>,         // LINK_FINGER1_TIP
+    RevoluteLink <LINK_PALM,        Axis::Z, kFinger2Offset, -1>,       // LINK_FINGER2
+    RevoluteLink <LINK_FINGER2,     Axis::Z, kFingerTipOffset, -1>      // LINK_FINGER2_TIP
+> RobotArmFK;
+
+static_assert(RobotArmFK::Size == ARM_LINK_COUNT, "RobotArmFK must list every ArmLink");
+
+// fast replacement for chain.UpdateDirty() on a chain built by BuildRobotArmChain():
+// only links downstream of a changed joint are evaluated, false = idle (no FK)
+inline bool UpdateRobotArmChain(KinematicChain& chain)
+{
+    // Sync() and the dirty mask in one branch-free pass
+    float* value = chain.value.data();
+    uint32_t dirty = 0;
+    for (int i = 0; i < ARM_LINK_COUNT; ++i)
+    {
+        const float* src = chain.joints[i].source;
+        float v = src ? *src : value[i];
+        dirty |= (uint32_t)((v != value[i]) | (chain.dirty[i] != 0)) << i;
+        value[i] = v;
+    }
+    if (!dirty)
+        return false;
+    RobotArmFK::Evaluate(value, chain.world.data(), dirty);
+    chain.MarkClean();
+    return true;
+}
+
+#endif
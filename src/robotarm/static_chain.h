@@ -0,0 +1,198 @@
+#ifndef STATIC_CHAIN_H
+#define STATIC_CHAIN_H
+
+#include <glm/glm.hpp>
+
+#include <robotarm/fast_trig.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// ======================================================================
+// Compile-time kinematic chain
+// ======================================================================
+//
+// Same semantics as KinematicChain (world[i] = world[parent] * T(offset) * Motion),
+// but axes, offsets, parents and signs are template arguments. Each link compiles
+// to its own straight-line code: zero offset components vanish and an axis-aligned
+// rotation touches only two columns. sin/cos of all links are evaluated up front,
+// four at a time.
+
+enum class Axis { X, Y, Z };
+
+struct Offset3
+{
+    float x, y, z;
+};
+
+constexpr Offset3 kNoOffset = { 0.0f, 0.0f, 0.0f };
+
+namespace staticchain {
+
+// one matrix column; SSE2 register when available, glm::vec4 otherwise
+#if defined(FAST_TRIG_SSE2)
+typedef __m128 Col;
+inline Col  Load(const glm::vec4& v)        { return _mm_loadu_ps(&v.x); }
+inline void Store(glm::vec4& v, Col c)      { _mm_storeu_ps(&v.x, c); }
+inline Col  Scale(Col a, float s)           { return _mm_mul_ps(a, _mm_set1_ps(s)); }
+inline Col  Add(Col a, Col b)               { return _mm_add_ps(a, b); }
+inline Col  Sub(Col a, Col b)               { return _mm_sub_ps(a, b); }
+inline Col  Unit(int k)                     { return _mm_setr_ps(k == 0, k == 1, k == 2, k == 3); }
+#else
+typedef glm::vec4 Col;
+inline Col  Load(const glm::vec4& v)        { return v; }
+inline void Store(glm::vec4& v, Col c)      { v = c; }
+inline Col  Scale(Col a, float s)           { return a * s; }
+inline Col  Add(Col a, Col b)               { return a + b; }
+inline Col  Sub(Col a, Col b)               { return a - b; }
+inline Col  Unit(int k)                     { Col u(0.0f); u[k] = 1.0f; return u; }
+#endif
+
+struct Frame
+{
+    Col c[4];
+};
+
+template <int Parent>
+inline Frame ParentFrame(const glm::mat4* world)
+{
+    if constexpr (Parent < 0)
+        return { { Unit(0), Unit(1), Unit(2), Unit(3) } };
+    else
+    {
+        const glm::mat4& P = world[Parent];
+        return { { Load(P[0]), Load(P[1]), Load(P[2]), Load(P[3]) } };
+    }
+}
+
+inline void StoreFrame(glm::mat4& M, const Frame& F)
+{
+    for (int i = 0; i < 4; ++i)
+        Store(M[i], F.c[i]);
+}
+
+template <const Offset3& Off>
+inline void TranslateConst(Frame& F)
+{
+    if constexpr (Off.x != 0.0f) F.c[3] = Add(F.c[3], Scale(F.c[0], Off.x));
+    if constexpr (Off.y != 0.0f) F.c[3] = Add(F.c[3], Scale(F.c[1], Off.y));
+    if constexpr (Off.z != 0.0f) F.c[3] = Add(F.c[3], Scale(F.c[2], Off.z));
+}
+
+// F = F * R(axis) with (c, s) = (cos, sin) of the angle
+template <Axis A>
+inline void RotateAxis(Frame& F, float c, float s)
+{
+    constexpr int a = (A == Axis::X) ? 1 : (A == Axis::Y) ? 2 : 0;
+    constexpr int b = (A == Axis::X) ? 2 : (A == Axis::Y) ? 0 : 1;
+    Col ca = F.c[a];
+    Col cb = F.c[b];
+    F.c[a] = Add(Scale(ca, c), Scale(cb, s));
+    F.c[b] = Sub(Scale(cb, c), Scale(ca, s));
+}
+
+} // namespace staticchain
+
+// Apply<Self>(world, value, sin, cos): sin/cos are of value (degrees), precomputed
+
+template <int Parent, const Offset3& Off>
+struct FixedLink
+{
+    static constexpr int ParentIndex = Parent;
+
+    template <int Self>
+    static void Apply(glm::mat4* world, float, float, float)
+    {
+        staticchain::Frame F = staticchain::ParentFrame<Parent>(world);
+        staticchain::TranslateConst<Off>(F);
+        staticchain::StoreFrame(world[Self], F);
+    }
+};
+
+template <int Parent, Axis A, const Offset3& Off = kNoOffset, int Sign = 1>
+struct RevoluteLink
+{
+    static constexpr int ParentIndex = Parent;
+
+    template <int Self>
+    static void Apply(glm::mat4* world, float, float s, float c)
+    {
+        staticchain::Frame F = staticchain::ParentFrame<Parent>(world);
+        staticchain::TranslateConst<Off>(F);
+        // mirrored link: sin(-a) = -sin(a)
+        staticchain::RotateAxis<A>(F, c, Sign < 0 ? -s : s);
+        staticchain::StoreFrame(world[Self], F);
+    }
+};
+
+template <int Parent, Axis A, const Offset3& Off = kNoOffset, int Sign = 1>
+struct PrismaticLink
+{
+    static constexpr int ParentIndex = Parent;
+
+    template <int Self>
+    static void Apply(glm::mat4* world, float value, float, float)
+    {
+        constexpr int k = (A == Axis::X) ? 0 : (A == Axis::Y) ? 1 : 2;
+        staticchain::Frame F = staticchain::ParentFrame<Parent>(world);
+        staticchain::TranslateConst<Off>(F);
+        F.c[3] = staticchain::Add(F.c[3], staticchain::Scale(F.c[k], Sign * value));
+        staticchain::StoreFrame(world[Self], F);
+    }
+};
+
+// Links must be listed parent-before-child; value[i] is link i's angle/position.
+template <class... Links>
+struct StaticChain
+{
+    static constexpr size_t Size = sizeof...(Links);
+    static_assert(Size <= 32, "dirty masks are 32 bits");
+
+    // dirty: bit i = link i's value changed. Those links and their descendants are
+    // recomputed; every other world[] entry is left as it was.
+    static void Evaluate(const float* value, glm::mat4* world, uint32_t dirty = ~0u)
+    {
+        uint32_t stale = Propagate(dirty, std::index_sequence_for<Links...>());
+        if (!stale)
+            return;
+
+        // sin/cos in blocks of 4 (fixed/prismatic lanes are just unused), stale blocks only
+        constexpr size_t Padded = (Size + 3) & ~size_t(3);
+        float v[Padded] = {}, s[Padded], c[Padded];
+        for (size_t i = 0; i < Size; ++i)
+            v[i] = value[i];
+        for (size_t i = 0; i < Padded; i += 4)
+            if ((stale >> i) & 0xFu)
+                fasttrig::SinCosDeg4(v + i, s + i, c + i);
+
+        Evaluate(v, s, c, world, stale, std::index_sequence_for<Links...>());
+    }
+
+private:
+    template <int Parent>
+    static constexpr uint32_t ParentBit(uint32_t mask)
+    {
+        if constexpr (Parent < 0)
+            return 0;
+        else
+            return (mask >> Parent) & 1u;
+    }
+
+    // left-to-right fold: parents are final before their children read them
+    template <size_t... I>
+    static uint32_t Propagate(uint32_t mask, std::index_sequence<I...>)
+    {
+        ((mask |= ParentBit<Links::ParentIndex>(mask) << I), ...);
+        return mask;
+    }
+
+    template <size_t... I>
+    static void Evaluate(const float* v, const float* s, const float* c, glm::mat4* world,
+                         uint32_t stale, std::index_sequence<I...>)
+    {
+        ((((stale >> I) & 1u) ? Links::template Apply<(int)I>(world, v[I], s[I], c[I]) : void()), ...);
+    }
+};
+
+#endif
@@ -0,0 +1,31 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+// per-instance (glVertexAttribDivisor 1), see render/instance_batch.h
+layout (location = 3) in mat4 iModel;
+layout (location = 7) in mat3 iNormal;
+layout (location = 10) in vec3 iColor;
+
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec3 Color;
+} vs_out;
+
+// shared per-frame block, see render/frame_uniforms.h
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;  float pad0;
+    vec3 lightPos; float pad1;
+};
+
+void main()
+{
+    vec4 world = iModel * vec4(aPos, 1.0);
+    vs_out.FragPos = world.xyz;
+    vs_out.Normal = iNormal * aNormal;
+    vs_out.Color = iColor;
+    gl_Position = projection * view * world;
+}
@@ -0,0 +1,47 @@
+#version 330 core
+out vec4 FragColor;
+
+in VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+    vec3 Color;
+} fs_in;
+
+// shared blocks, see render/frame_uniforms.h
+layout (std140) uniform FrameData {
+    mat4 projection;
+    mat4 view;
+    vec3 viewPos;  float pad0;
+    vec3 lightPos; float pad1;
+};
+layout (std140) uniform LightData {
+    vec3 lightColor;
+    float ambientStrength;
+    float specularStrength;
+    float shininess;
+};
+
+uniform sampler2D texture_diffuse1;
+uniform bool hasTextures;
+
+void main()
+{
+    vec3 color = hasTextures ? texture(texture_diffuse1, fs_in.TexCoords).rgb : fs_in.Color;
+
+    // ambient
+    vec3 ambient = ambientStrength * color;
+    // diffuse
+    vec3 lightDir = normalize(lightPos - fs_in.FragPos);
+    vec3 normal = normalize(fs_in.Normal);
+    float diff = max(dot(lightDir, normal), 0.0);
+    vec3 diffuse = diff * color * lightColor;
+
+    // specular (Blinn-Phong)
+    vec3 viewDir = normalize(viewPos - fs_in.FragPos);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), shininess);
+    vec3 specular = specularStrength * lightColor * spec;
+
+    FragColor = vec4(ambient + diffuse + specular, 1.0);
+}
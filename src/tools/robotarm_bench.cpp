@@ -0,0 +1,504 @@
+/*
+Headless kinematics benchmark suite (no window / GL context).
+
+Covers the per-frame paths of RobotArm (ComputePalmMatrix, the link chain that
+myDisplay() draws from, CanGrabTeapot) and the batch / IK / reach map paths:
+
+    robotarm_bench [--filter substring] [--json file] [--label text] [--quick]
+                   [--reach robot_arm.reach]
+
+Every benchmark is timed in groups of calls sized to take ~2 us, so the per-op
+percentiles are not dominated by clock overhead. Reported per op: mean ns,
+throughput and p50 / p90 / p99 of the group means. --json writes the same table
+(plus build info and --label, e.g. a commit hash) for tracking across commits.
+Build in Release: the numbers are meaningless without optimisation.
+
+Alongside the timings it checks that the SIMD batch FK kernels match the scalar
+one bit for bit and that DLS handles prismatic and wound-up revolute dofs; the
+exit code is non-zero if any check fails.
+*/
+
+#include <robotarm/arm_ik.h>
+#include <robotarm/batch_fk.h>
+#include <robotarm/dls_ik.h>
+#include <robotarm/grasp.h>
+#include <robotarm/reach_map.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// joint configurations cycled through by every benchmark so nothing can be hoisted
+struct PoseSet
+{
+    std::vector<float> value[ARM_DOF];
+    size_t count;   // power of two
+};
+
+static PoseSet MakePoses(size_t count, unsigned seed)
+{
+    PoseSet P;
+    P.count = count;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> pos(-1.0f, 1.0f);
+    for (int d = 0; d < ARM_DOF; ++d)
+    {
+        P.value[d].resize(count);
+        for (size_t i = 0; i < count; ++i)
+            P.value[d][i] = (d == DOF_BASE_X || d == DOF_BASE_Z) ? pos(rng) : angle(rng);
+    }
+    return P;
+}
+
+// ----------------------------------------------------------------------
+// Harness
+// ----------------------------------------------------------------------
+
+struct BenchResult
+{
+    std::string name;
+    double      nsPerOp;
+    double      p50, p90, p99;
+    uint64_t    ops;
+};
+
+class BenchSuite
+{
+public:
+    std::string              filter;
+    bool                     quick = false;
+    std::vector<BenchResult> results;
+    double                   sink = 0.0;    // benchmark bodies add results here
+
+    // body(i) performs opsPerCall operations on input i (i keeps increasing)
+    template <class Body>
+    void Run(const char* name, size_t opsPerCall, Body body)
+    {
+        if (!filter.empty() && std::strstr(name, filter.c_str()) == nullptr)
+            return;
+
+        size_t i = 0;
+        // warm up caches / branch predictors, then size the timing group
+        Clock::time_point w0 = Clock::now();
+        size_t calls = 0;
+        while (Clock::now() - w0 < std::chrono::milliseconds(quick ? 2 : 20))
+        {
+            body(i++);
+            ++calls;
+        }
+        double nsPerCall = std::chrono::duration<double, std::nano>(Clock::now() - w0).count() / calls;
+        size_t group = (size_t)std::max(1.0, std::ceil(2000.0 / nsPerCall));
+
+        const int kGroups = quick ? 500 : 5000;
+        std::vector<double> perOp(kGroups);
+        double totalNs = 0.0;
+        for (int g = 0; g < kGroups; ++g)
+        {
+            Clock::time_point t0 = Clock::now();
+            for (size_t k = 0; k < group; ++k)
+                body(i++);
+            double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+            totalNs += ns;
+            perOp[g] = ns / (double)(group * opsPerCall);
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        BenchResult r;
+        r.name    = name;
+        r.ops     = (uint64_t)kGroups * group * opsPerCall;
+        r.nsPerOp = totalNs / (double)r.ops;
+        r.p50     = perOp[kGroups / 2];
+        r.p90     = perOp[kGroups * 9 / 10];
+        r.p99     = perOp[kGroups * 99 / 100];
+        results.push_back(r);
+
+        std::printf("%-28s %10.1f %12.3f %10.1f %10.1f %10.1f\n",
+                    name, r.nsPerOp, 1e3 / r.nsPerOp, r.p50, r.p90, r.p99);
+        std::fflush(stdout);
+    }
+
+    // null if the benchmark was filtered out
+    const BenchResult* Find(const char* name) const
+    {
+        for (size_t k = 0; k < results.size(); ++k)
+            if (results[k].name == name)
+                return &results[k];
+        return nullptr;
+    }
+
+    bool WriteJson(const char* path, const char* label) const
+    {
+        FILE* fp = std::fopen(path, "w");
+        if (!fp)
+        {
+            std::printf("cannot write %s\n", path);
+            return false;
+        }
+        char date[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+        std::string escaped;
+        for (const char* c = label; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+                escaped += '\\';
+            escaped += *c;
+        }
+        std::fprintf(fp, "{\n  \"label\": \"%s\",\n  \"date\": \"%s\",\n", escaped.c_str(), date);
+        std::fprintf(fp, "  \"compiler\": \"%s\",\n", CompilerName());
+#ifdef NDEBUG
+        std::fprintf(fp, "  \"ndebug\": true,\n");
+#else
+        std::fprintf(fp, "  \"ndebug\": false,\n");
+#endif
+        std::fprintf(fp, "  \"fk_kernel\": \"%s\",\n", FKKernelName(DetectFKKernel()));
+        std::fprintf(fp, "  \"benchmarks\": [\n");
+        for (size_t k = 0; k < results.size(); ++k)
+        {
+            const BenchResult& r = results[k];
+            std::fprintf(fp, "    { \"name\": \"%s\", \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, "
+                             "\"p50_ns\": %.3f, \"p90_ns\": %.3f, \"p99_ns\": %.3f, \"ops\": %llu }%s\n",
+                         r.name.c_str(), r.nsPerOp, 1e9 / r.nsPerOp, r.p50, r.p90, r.p99,
+                         (unsigned long long)r.ops, k + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(fp, "  ]\n}\n");
+        return std::fclose(fp) == 0;
+    }
+
+    static const char* CompilerName()
+    {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc";
+#else
+        return "unknown";
+#endif
+    }
+};
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    BenchSuite suite;
+    const char* jsonPath = nullptr;
+    const char* label = "";
+    const char* reachPath = "robot_arm.reach";
+    for (int a = 1; a < argc; ++a)
+    {
+        if (!std::strcmp(argv[a], "--quick"))
+            suite.quick = true;
+        else if (!std::strcmp(argv[a], "--filter") && a + 1 < argc)
+            suite.filter = argv[++a];
+        else if (!std::strcmp(argv[a], "--json") && a + 1 < argc)
+            jsonPath = argv[++a];
+        else if (!std::strcmp(argv[a], "--label") && a + 1 < argc)
+            label = argv[++a];
+        else if (!std::strcmp(argv[a], "--reach") && a + 1 < argc)
+            reachPath = argv[++a];
+        else
+        {
+            std::printf("usage: %s [--filter substring] [--json file] [--label text] [--quick] [--reach file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+#ifndef NDEBUG
+    std::printf("warning: built without NDEBUG, timings are not representative\n");
+#endif
+    const size_t kPoses = 4096;
+    const size_t kMask = kPoses - 1;
+    PoseSet P = MakePoses(kPoses, 1234);
+
+    float q[ARM_DOF] = {};
+    const float* src[ARM_DOF];
+    for (int d = 0; d < ARM_DOF; ++d)
+        src[d] = &q[d];
+
+    KinematicChain generic, special;
+    BuildRobotArmChain(generic, src);
+    BuildRobotArmChain(special, src);
+    RigidKinematicChain rigid;
+    BuildRobotArmChain(rigid, src);
+
+    auto load = [&](size_t i) {
+        for (int d = 0; d < ARM_DOF; ++d)
+            q[d] = P.value[d][i & kMask];
+    };
+
+    std::printf("%-28s %10s %12s %10s %10s %10s\n", "benchmark", "ns/op", "Mops/s", "p50", "p90", "p99");
+
+    // ---- chain ----
+    suite.Run("chain_generic_update", 1, [&](size_t i) {
+        load(i);
+        generic.Update();
+        suite.sink += generic.World(LINK_FINGER2_TIP)[3].x;
+    });
+    suite.Run("chain_static_update", 1, [&](size_t i) {
+        load(i);
+        UpdateRobotArmChain(special);
+        suite.sink += special.World(LINK_FINGER2_TIP)[3].x;
+    });
+    // what the compile-time specialisation buys over the generic chain (aim: 5x)
+    {
+        const BenchResult* g = suite.Find("chain_generic_update");
+        const BenchResult* st = suite.Find("chain_static_update");
+        if (g && st)
+            std::printf("%-28s %9.2fx (p50 %.2fx)\n", "  generic/static", g->nsPerOp / st->nsPerOp, g->p50 / st->p50);
+    }
+    suite.Run("chain_rigid_update", 1, [&](size_t i) {
+        load(i);
+        rigid.Update();
+        suite.sink += rigid.World(LINK_FINGER2_TIP).t.x;
+    });
+    // incremental: only the fingers move (mouse finger drag), then nothing moves
+    suite.Run("chain_static_fingers_only", 1, [&](size_t i) {
+        q[DOF_FINGER1] = P.value[DOF_FINGER1][i & kMask];
+        q[DOF_FINGER2] = P.value[DOF_FINGER2][i & kMask];
+        UpdateRobotArmChain(special);
+        suite.sink += special.World(LINK_FINGER2_TIP)[3].x;
+    });
+    suite.Run("chain_static_idle", 1, [&](size_t) {
+        UpdateRobotArmChain(special);
+        suite.sink += special.World(LINK_FINGER2_TIP)[3].x;
+    });
+
+    // ---- RobotArm per-frame paths ----
+    // myDisplay(): update once, then every drawn link reads its world transform
+    static const int kDrawnLinks[] = { LINK_BASE, LINK_SHOULDER, LINK_ELBOW, LINK_WRIST, LINK_PALM,
+                                       LINK_FINGER1, LINK_FINGER1_TIP, LINK_FINGER2, LINK_FINGER2_TIP };
+    const size_t kDrawnCount = sizeof(kDrawnLinks) / sizeof(kDrawnLinks[0]);
+    glm::mat4 drawn[kDrawnCount];
+    suite.Run("display_chain", 1, [&](size_t i) {
+        load(i);
+        UpdateRobotArmChain(special);
+        for (size_t k = 0; k < kDrawnCount; ++k)
+            drawn[k] = special.World(kDrawnLinks[k]);
+        suite.sink += drawn[i % kDrawnCount][3].y;
+    });
+    suite.Run("compute_palm_matrix", 1, [&](size_t i) {
+        load(i);
+        suite.sink += PalmMatrix(special)[3].x;
+    });
+    const glm::vec3 teapot(0.5f, 0.0f, 0.0f);
+    suite.Run("can_grab_teapot", 1, [&](size_t i) {
+        load(i);
+        suite.sink += CanGrasp(special, q[DOF_FINGER1], q[DOF_FINGER2], teapot) ? 1.0 : 0.0;
+    });
+
+    // ---- batch FK, per pose ----
+    {
+        const size_t kBatch = 1024;
+        std::vector<float> buf[3 * 3 + 9];
+        for (std::vector<float>& b : buf)
+            b.resize(kBatch);
+        ArmPosesSoA out = {};
+        out.palm = { buf[0].data(), buf[1].data(), buf[2].data(), {} };
+        for (int r = 0; r < 9; ++r)
+            out.palm.rot[r] = buf[9 + r].data();
+        out.tip1 = { buf[3].data(), buf[4].data(), buf[5].data(), {} };
+        out.tip2 = { buf[6].data(), buf[7].data(), buf[8].data(), {} };
+
+        const FKKernel kernels[] = { FKKernel::Scalar, FKKernel::SSE, FKKernel::AVX2, FKKernel::AVX512 };
+        for (FKKernel k : kernels)
+        {
+            ArmJointsSoA in;
+            for (int d = 0; d < ARM_DOF; ++d)
+                in.dof[d] = P.value[d].data();
+            // skip kernels this build / CPU cannot run (the dispatcher would fall back)
+            if (BatchForwardKinematics(in, out, 16, k) != k)
+                continue;
+            std::string name = std::string("batch_fk_") + FKKernelName(k);
+            suite.Run(name.c_str(), kBatch, [&](size_t i) {
+                size_t first = (i * kBatch) & kMask;
+                for (int d = 0; d < ARM_DOF; ++d)
+                    in.dof[d] = P.value[d].data() + first;
+                BatchForwardKinematics(in, out, kBatch, k);
+                suite.sink += out.tip2.x[i & (kBatch - 1)];
+            });
+        }
+    }
+
+    // check: every SIMD kernel must match the scalar fallback bit for bit
+    // (the count is not a multiple of any vector width, so the tails are covered too)
+    bool batchOk = true;
+    {
+        const size_t kCheck = (1u << 16) - 3;
+        PoseSet C = MakePoses(1u << 16, 4321);
+        ArmJointsSoA in;
+        for (int d = 0; d < ARM_DOF; ++d)
+            in.dof[d] = C.value[d].data();
+
+        // 3 poses x (xyz + 9 rotation) floats, laid out as 36 arrays
+        auto bind = [&](std::vector<float>& buf) {
+            buf.assign(36 * kCheck, 0.0f);
+            PoseSoA* pose[3];
+            ArmPosesSoA out;
+            pose[0] = &out.palm; pose[1] = &out.tip1; pose[2] = &out.tip2;
+            for (int p = 0; p < 3; ++p)
+            {
+                float* base = buf.data() + (size_t)p * 12 * kCheck;
+                pose[p]->x = base;
+                pose[p]->y = base + kCheck;
+                pose[p]->z = base + 2 * kCheck;
+                for (int r = 0; r < 9; ++r)
+                    pose[p]->rot[r] = base + (size_t)(3 + r) * kCheck;
+            }
+            return out;
+        };
+        std::vector<float> expected, actual;
+        BatchForwardKinematics(in, bind(expected), kCheck, FKKernel::Scalar);
+
+        const FKKernel kernels[] = { FKKernel::SSE, FKKernel::AVX2, FKKernel::AVX512 };
+        for (FKKernel k : kernels)
+        {
+            if (BatchForwardKinematics(in, bind(actual), kCheck, k) != k)
+                continue;
+            size_t mismatches = 0;
+            for (size_t n = 0; n < expected.size(); ++n)
+                if (std::memcmp(&expected[n], &actual[n], sizeof(float)) != 0)
+                    ++mismatches;
+            if (mismatches)
+                batchOk = false;
+            std::printf("batch fk bitwise check %s: %s (%zu of %zu floats differ from scalar)\n",
+                        FKKernelName(k), mismatches ? "FAILED" : "ok", mismatches, expected.size());
+        }
+    }
+
+    // ---- IK ----
+    bool prismaticOk = true, wrapOk = true;
+    {
+        // reachable palm targets from in-limit poses, and a nearby warm start for DLS
+        ArmJointLimits limits = DefaultArmJointLimits();
+        std::mt19937 rng(99);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f), noise(-5.0f, 5.0f);
+        std::vector<glm::mat4> target(kPoses);
+        std::vector<float> start(kPoses * IK_DOF);
+        KinematicChain ref;
+        BuildRobotArmChain(ref, src);
+        std::fill(q, q + ARM_DOF, 0.0f);
+        for (size_t i = 0; i < kPoses; ++i)
+        {
+            for (int j = 0; j < IK_DOF; ++j)
+            {
+                int d = DOF_BASE_SPIN + j;
+                q[d] = limits.lo[d] + unit(rng) * (limits.hi[d] - limits.lo[d]);
+                start[i * IK_DOF + j] = glm::clamp(q[d] + noise(rng), limits.lo[d], limits.hi[d]);
+            }
+            UpdateRobotArmChain(ref);
+            target[i] = ref.World(LINK_PALM);
+        }
+
+        suite.Run("ik_closed_form", 1, [&](size_t i) {
+            IKResult r = SolveArmIK(target[i & kMask], 0.0f, 0.0f, limits);
+            suite.sink += r.count;
+        });
+
+        float* dofs[IK_DOF];
+        for (int j = 0; j < IK_DOF; ++j)
+            dofs[j] = &q[DOF_BASE_SPIN + j];
+        DLSIKSolver dls(ref, LINK_PALM, dofs, IK_DOF, limits.lo + DOF_BASE_SPIN, limits.hi + DOF_BASE_SPIN);
+        suite.Run("ik_dls_position", 1, [&](size_t i) {
+            for (int j = 0; j < IK_DOF; ++j)
+                *dofs[j] = start[(i & kMask) * IK_DOF + j];
+            DLSIKResult r = dls.Solve(target[i & kMask]);
+            suite.sink += r.iterations;
+        });
+
+        // base translation (prismatic, world units) solved together with the revolute joints
+        float* baseDofs[2 + IK_DOF];
+        for (int j = 0; j < 2 + IK_DOF; ++j)
+            baseDofs[j] = &q[DOF_BASE_X + j];
+        DLSIKSolver dlsBase(ref, LINK_PALM, baseDofs, 2 + IK_DOF, limits.lo + DOF_BASE_X, limits.hi + DOF_BASE_X);
+        suite.Run("ik_dls_position_base", 1, [&](size_t i) {
+            q[DOF_BASE_X] = q[DOF_BASE_Z] = 0.0f;
+            for (int j = 0; j < IK_DOF; ++j)
+                *dofs[j] = start[(i & kMask) * IK_DOF + j];
+            DLSIKResult r = dlsBase.Solve(target[i & kMask]);
+            suite.sink += r.iterations;
+        });
+
+        // check: a pure translation of the palm must be taken up by the base slides alone
+        float* slideDofs[2] = { &q[DOF_BASE_X], &q[DOF_BASE_Z] };
+        DLSIKSolver slide(ref, LINK_PALM, slideDofs, 2, limits.lo + DOF_BASE_X, limits.hi + DOF_BASE_X);
+        const glm::vec3 kSlide(0.3f, 0.0f, -0.2f);
+        q[DOF_BASE_X] = q[DOF_BASE_Z] = 0.0f;
+        for (int j = 0; j < IK_DOF; ++j)
+            *dofs[j] = start[j];
+        UpdateRobotArmChain(ref);
+        glm::mat4 moved = ref.World(LINK_PALM);
+        moved[3] += glm::vec4(kSlide, 0.0f);
+        DLSIKResult r = slide.Solve(moved);
+        prismaticOk = r.converged && std::fabs(q[DOF_BASE_X] - kSlide.x) < 1e-3f && std::fabs(q[DOF_BASE_Z] - kSlide.z) < 1e-3f;
+        std::printf("dls prismatic check: %s (base %g %g after %d iterations, expected %g %g)\n",
+                    prismaticOk ? "ok" : "FAILED", q[DOF_BASE_X], q[DOF_BASE_Z], r.iterations, kSlide.x, kSlide.z);
+
+        // check: a base spin wound two turns past its +-180 limit is wrapped, not pinned
+        q[DOF_BASE_X] = q[DOF_BASE_Z] = 0.0f;
+        for (int j = 0; j < IK_DOF; ++j)
+            *dofs[j] = start[j];
+        const float kSpin = q[DOF_BASE_SPIN];
+        UpdateRobotArmChain(ref);
+        glm::mat4 spun = ref.World(LINK_PALM);
+        q[DOF_BASE_SPIN] += 720.0f;
+        r = dls.Solve(spun);
+        wrapOk = r.converged && std::fabs(q[DOF_BASE_SPIN] - kSpin) < 0.1f;
+        std::printf("dls wrap check: %s (spin %g after %d iterations, expected %g)\n",
+                    wrapOk ? "ok" : "FAILED", q[DOF_BASE_SPIN], r.iterations, kSpin);
+    }
+
+    // ---- reach map (only if one has been built) ----
+    {
+        ReachMap map;
+        if (map.Open(reachPath))
+        {
+            suite.Run("reach_map_lookup", 1, [&](size_t i) {
+                glm::vec3 p(P.value[DOF_BASE_X][i & kMask],
+                            0.4f + 0.75f * P.value[DOF_BASE_Z][(i + 1) & kMask],
+                            P.value[DOF_BASE_Z][i & kMask]);
+                suite.sink += map.Reachable(p) ? 1.0 : 0.0;
+            });
+        }
+        else if (suite.filter.empty())
+            std::printf("(reach_map_lookup skipped: %s not found)\n", reachPath);
+    }
+
+    // ---- consistency: all chain representations must agree ----
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < P.count; i += 7)
+    {
+        load(i);
+        generic.Update();
+        UpdateRobotArmChain(special);
+        rigid.Update();
+        for (int l = 0; l < ARM_LINK_COUNT; ++l)
+        {
+            glm::mat4 R = ToMat4(rigid.World(l));
+            for (int c = 0; c < 4; ++c)
+                for (int r = 0; r < 4; ++r)
+                {
+                    maxDiff = glm::max(maxDiff, std::fabs(generic.world[l][c][r] - special.world[l][c][r]));
+                    maxDiff = glm::max(maxDiff, std::fabs(generic.world[l][c][r] - R[c][r]));
+                }
+        }
+    }
+    std::printf("chain max |diff| %g, bytes per link: mat4 %zu, rigid %zu (checksum %g)\n",
+                maxDiff, sizeof(glm::mat4), sizeof(RigidTransform), suite.sink);
+
+    if (jsonPath && !suite.WriteJson(jsonPath, label))
+        return 1;
+    return (prismaticOk && wrapOk && batchOk) ? 0 : 1;
+}
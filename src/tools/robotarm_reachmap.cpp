@@ -0,0 +1,72 @@
+/*
+Offline reachability map builder (no window / GL context).
+
+Samples the arm FK over the joint limits and writes the voxel map that RobotArm
+maps at startup for O(1) reachability and IK seed lookups:
+
+    robotarm_reachmap [output] [--voxel metres] [--samples n] [--seed n]
+
+The default output is the path RobotArm loads, relative to the repo root.
+*/
+
+#include <robotarm/reach_map.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv)
+{
+    const char* path = "robot_arm.reach";
+    ReachMapBuildOptions options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--voxel") && i + 1 < argc)
+            options.voxelSize = (float)std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--samples") && i + 1 < argc)
+            options.samples = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+            options.seed = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        else if (argv[i][0] != '-')
+            path = argv[i];
+        else
+        {
+            std::printf("usage: %s [output] [--voxel metres] [--samples n] [--seed n]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (options.voxelSize <= 0.0f)
+    {
+        std::printf("voxel size must be positive\n");
+        return 1;
+    }
+
+    std::printf("building %s: voxel %.3f m, %llu samples\n",
+                path, options.voxelSize, (unsigned long long)options.samples);
+
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    if (!BuildReachMap(path, options))
+        return 1;
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    ReachMap map;
+    if (!map.Open(path))
+        return 1;
+    const ReachMapHeader& h = map.Header();
+    size_t reached = 0;
+    for (uint32_t z = 0; z < h.dims[2]; ++z)
+        for (uint32_t y = 0; y < h.dims[1]; ++y)
+            for (uint32_t x = 0; x < h.dims[0]; ++x)
+            {
+                glm::vec3 p(h.origin[0] + (x + 0.5f) * h.voxelSize,
+                            h.origin[1] + (y + 0.5f) * h.voxelSize,
+                            h.origin[2] + (z + 0.5f) * h.voxelSize);
+                reached += map.Reachable(p);
+            }
+
+    std::printf("%u x %u x %u cells, %zu reachable (%.1f%%), %.1f s\n",
+                h.dims[0], h.dims[1], h.dims[2], reached, 100.0 * reached / h.cellCount, sec);
+    return 0;
+}
@@ -0,0 +1,475 @@
+/*
+Monte Carlo workspace sampler (no window / GL context).
+
+Samples joint space uniformly inside the joint limits, runs the batched FK and
+accumulates:
+    <prefix>_envelope.csv      palm reach envelope (voxel, hit count), base-local
+    <prefix>_orientation.csv   palm Y axis coverage (azimuth x elevation bins)
+    <prefix>_clearance.csv     lowest fingertip height above the ground (1 cm bins)
+and optionally the palm positions as a binary PLY point cloud.
+
+    robotarm_workspace [--samples n] [--threads n] [--seed n] [--chunk n]
+                       [--voxel metres] [--hist prefix] [--points file.ply]
+
+Joint space is cut into chunks of --chunk samples. Every chunk has its own RNG
+stream derived from (seed, chunk index), and each chunk's points go to a fixed
+offset in the PLY, so the output is identical for any thread count or schedule.
+Threads start with a contiguous range of chunks and steal from the far end of
+other threads' ranges when they run out.
+*/
+
+#include <robotarm/batch_fk.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ----------------------------------------------------------------------
+// RNG: splitmix64, one stream per chunk
+// ----------------------------------------------------------------------
+
+static uint64_t SplitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// [0, 1) from the top 24 bits (same on every platform, unlike std distributions)
+static float Uniform01(uint64_t& state)
+{
+    return (float)(SplitMix64(state) >> 40) * (1.0f / 16777216.0f);
+}
+
+// ----------------------------------------------------------------------
+// Work stealing: one deque of chunk indices per thread
+// ----------------------------------------------------------------------
+
+class ChunkQueues
+{
+public:
+    ChunkQueues(int threads, uint64_t chunkCount)
+    {
+        for (int t = 0; t < threads; ++t)
+        {
+            queues.emplace_back(new Queue);
+            uint64_t lo = chunkCount * t / threads, hi = chunkCount * (t + 1) / threads;
+            for (uint64_t c = lo; c < hi; ++c)
+                queues[t]->chunks.push_back(c);
+        }
+    }
+
+    // own chunks in order from the front, otherwise steal from the back of a victim
+    bool Next(int self, uint64_t& chunk, bool& stolen)
+    {
+        int n = (int)queues.size();
+        for (int k = 0; k < n; ++k)
+        {
+            Queue& q = *queues[(self + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.chunks.empty())
+                continue;
+            if (k == 0)
+            {
+                chunk = q.chunks.front();
+                q.chunks.pop_front();
+            }
+            else
+            {
+                chunk = q.chunks.back();
+                q.chunks.pop_back();
+            }
+            stolen = (k != 0);
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex           mutex;
+        std::deque<uint64_t> chunks;
+    };
+    std::vector<std::unique_ptr<Queue>> queues;
+};
+
+// ----------------------------------------------------------------------
+// Accumulators (per thread, merged at the end)
+// ----------------------------------------------------------------------
+
+const int   kAzimuthBins   = 72;    // 5 degrees
+const int   kElevationBins = 36;    // 5 degrees
+const float kClearanceMin  = -2.0f;
+const float kClearanceStep = 0.01f;
+const int   kClearanceBins = 400;
+
+struct Options
+{
+    uint64_t    samples = 100000000;
+    int         threads = 0;
+    uint64_t    seed    = 1;
+    uint64_t    chunk   = 65536;
+    float       voxel   = 0.05f;
+    std::string hist    = "workspace";
+    std::string points;
+};
+
+struct Grid
+{
+    float    origin[3];
+    float    voxel;
+    uint32_t dims[3];
+};
+
+struct Accum
+{
+    std::vector<uint64_t> envelope;
+    std::vector<uint64_t> orientation;
+    std::vector<uint64_t> clearance;
+    uint64_t              chunks = 0;
+    uint64_t              stolen = 0;
+};
+
+// points are streamed: each chunk owns a fixed slice of the file
+class PointWriter
+{
+public:
+    bool Open(const std::string& path, uint64_t count)
+    {
+        fp = std::fopen(path.c_str(), "wb");
+        if (!fp)
+        {
+            std::printf("cannot write %s\n", path.c_str());
+            return false;
+        }
+        char header[256];
+        int len = std::snprintf(header, sizeof(header),
+                                "ply\nformat binary_little_endian 1.0\nelement vertex %llu\n"
+                                "property float x\nproperty float y\nproperty float z\nend_header\n",
+                                (unsigned long long)count);
+        headerSize = (uint64_t)len;
+        return std::fwrite(header, 1, (size_t)len, fp) == (size_t)len;
+    }
+
+    bool Write(uint64_t firstPoint, const float* xyz, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint64_t offset = headerSize + firstPoint * 3 * sizeof(float);
+#if defined(_WIN32)
+        if (_fseeki64(fp, (long long)offset, SEEK_SET) != 0)
+#else
+        if (fseeko(fp, (off_t)offset, SEEK_SET) != 0)
+#endif
+            return false;
+        return std::fwrite(xyz, 3 * sizeof(float), count, fp) == count;
+    }
+
+    bool Close()
+    {
+        bool ok = fp && std::fclose(fp) == 0;
+        fp = nullptr;
+        return ok;
+    }
+
+    bool IsOpen() const { return fp != nullptr; }
+
+private:
+    FILE*      fp = nullptr;
+    uint64_t   headerSize = 0;
+    std::mutex mutex;
+};
+
+// ----------------------------------------------------------------------
+// Sampling
+// ----------------------------------------------------------------------
+
+const size_t kBlock = 1024;   // samples per batched FK call
+
+// per-thread SoA buffers for one FK block
+struct Scratch
+{
+    std::vector<float> dof[ARM_DOF];
+    std::vector<float> palm[3 + 9];     // xyz + rotation
+    std::vector<float> tip1[3], tip2[3];
+    std::vector<float> xyz;             // interleaved palm positions for the PLY
+
+    ArmJointsSoA in;
+    ArmPosesSoA  out;
+
+    Scratch()
+    {
+        for (int d = 0; d < ARM_DOF; ++d)
+        {
+            dof[d].resize(kBlock);
+            in.dof[d] = dof[d].data();
+        }
+        for (std::vector<float>& b : palm) b.resize(kBlock);
+        for (std::vector<float>& b : tip1) b.resize(kBlock);
+        for (std::vector<float>& b : tip2) b.resize(kBlock);
+        xyz.resize(3 * kBlock);
+
+        out.palm = { palm[0].data(), palm[1].data(), palm[2].data(), {} };
+        for (int r = 0; r < 9; ++r)
+            out.palm.rot[r] = palm[3 + r].data();
+        out.tip1 = { tip1[0].data(), tip1[1].data(), tip1[2].data(), {} };
+        out.tip2 = { tip2[0].data(), tip2[1].data(), tip2[2].data(), {} };
+    }
+};
+
+static void SampleChunk(const Options& opt, const Grid& grid, const ArmJointLimits& limits,
+                        uint64_t chunk, Accum& acc, Scratch& scratch, PointWriter& points,
+                        std::atomic<bool>& ioError)
+{
+    uint64_t first = chunk * opt.chunk;
+    uint64_t count = std::min<uint64_t>(opt.chunk, opt.samples - first);
+
+    // stream depends only on (seed, chunk)
+    uint64_t rng = opt.seed ^ (chunk * 0xd1b54a32d192ed03ull);
+    SplitMix64(rng);
+
+    const ArmPosesSoA& out = scratch.out;
+    float* xyz = scratch.xyz.data();
+
+    for (uint64_t done = 0; done < count; done += kBlock)
+    {
+        size_t n = (size_t)std::min<uint64_t>(kBlock, count - done);
+
+        for (int d = 0; d < ARM_DOF; ++d)
+        {
+            float* v = scratch.dof[d].data();
+            if (d == DOF_BASE_X || d == DOF_BASE_Z)
+            {
+                std::fill(v, v + n, 0.0f);
+                continue;
+            }
+            float lo = limits.lo[d], span = limits.hi[d] - limits.lo[d];
+            for (size_t i = 0; i < n; ++i)
+                v[i] = lo + Uniform01(rng) * span;
+        }
+
+        BatchForwardKinematics(scratch.in, out, n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            float px = out.palm.x[i], py = out.palm.y[i], pz = out.palm.z[i];
+
+            float fx = (px - grid.origin[0]) / grid.voxel;
+            float fy = (py - grid.origin[1]) / grid.voxel;
+            float fz = (pz - grid.origin[2]) / grid.voxel;
+            if (fx >= 0.0f && fy >= 0.0f && fz >= 0.0f &&
+                fx < grid.dims[0] && fy < grid.dims[1] && fz < grid.dims[2])
+                ++acc.envelope[((size_t)(uint32_t)fz * grid.dims[1] + (uint32_t)fy) * grid.dims[0] + (uint32_t)fx];
+
+            float ax = out.palm.rot[3][i], ay = out.palm.rot[4][i], az = out.palm.rot[5][i];
+            float azimuth = std::atan2(az, ax);                                 // [-pi, pi]
+            float elevation = std::asin(std::max(-1.0f, std::min(1.0f, ay)));   // [-pi/2, pi/2]
+            int ia = std::min(kAzimuthBins - 1, (int)((azimuth + 3.14159265f) * (kAzimuthBins / 6.28318531f)));
+            int ie = std::min(kElevationBins - 1, (int)((elevation + 1.57079633f) * (kElevationBins / 3.14159265f)));
+            ++acc.orientation[(size_t)std::max(ie, 0) * kAzimuthBins + std::max(ia, 0)];
+
+            float lowest = std::min(out.tip1.y[i], out.tip2.y[i]);
+            int ic = (int)std::floor((lowest - kClearanceMin) / kClearanceStep);
+            ++acc.clearance[std::max(0, std::min(kClearanceBins - 1, ic))];
+
+            if (points.IsOpen())
+            {
+                xyz[3 * i + 0] = px;
+                xyz[3 * i + 1] = py;
+                xyz[3 * i + 2] = pz;
+            }
+        }
+
+        if (points.IsOpen() && !points.Write(first + done, xyz, n))
+            ioError = true;
+    }
+}
+
+static bool WriteHistograms(const Options& opt, const Grid& grid, const Accum& total)
+{
+    std::string path = opt.hist + "_envelope.csv";
+    FILE* fp = std::fopen(path.c_str(), "w");
+    if (!fp)
+    {
+        std::printf("cannot write %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(fp, "x,y,z,count\n");
+    for (uint32_t z = 0; z < grid.dims[2]; ++z)
+        for (uint32_t y = 0; y < grid.dims[1]; ++y)
+            for (uint32_t x = 0; x < grid.dims[0]; ++x)
+            {
+                uint64_t c = total.envelope[((size_t)z * grid.dims[1] + y) * grid.dims[0] + x];
+                if (c)
+                    std::fprintf(fp, "%.4f,%.4f,%.4f,%llu\n",
+                                 grid.origin[0] + (x + 0.5f) * grid.voxel,
+                                 grid.origin[1] + (y + 0.5f) * grid.voxel,
+                                 grid.origin[2] + (z + 0.5f) * grid.voxel, (unsigned long long)c);
+            }
+    std::fclose(fp);
+
+    path = opt.hist + "_orientation.csv";
+    fp = std::fopen(path.c_str(), "w");
+    if (!fp)
+        return false;
+    std::fprintf(fp, "azimuth_deg,elevation_deg,count\n");
+    for (int e = 0; e < kElevationBins; ++e)
+        for (int a = 0; a < kAzimuthBins; ++a)
+            std::fprintf(fp, "%.1f,%.1f,%llu\n",
+                         -180.0f + (a + 0.5f) * (360.0f / kAzimuthBins),
+                         -90.0f + (e + 0.5f) * (180.0f / kElevationBins),
+                         (unsigned long long)total.orientation[(size_t)e * kAzimuthBins + a]);
+    std::fclose(fp);
+
+    path = opt.hist + "_clearance.csv";
+    fp = std::fopen(path.c_str(), "w");
+    if (!fp)
+        return false;
+    std::fprintf(fp, "height_m,count\n");
+    for (int i = 0; i < kClearanceBins; ++i)
+        std::fprintf(fp, "%.3f,%llu\n", kClearanceMin + i * kClearanceStep,
+                     (unsigned long long)total.clearance[i]);
+    std::fclose(fp);
+    return true;
+}
+
+static bool ParseArgs(int argc, char** argv, Options& opt)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!v)
+            return false;
+        if (!std::strcmp(a, "--samples"))      opt.samples = std::strtoull(v, nullptr, 10);
+        else if (!std::strcmp(a, "--threads")) opt.threads = std::atoi(v);
+        else if (!std::strcmp(a, "--seed"))    opt.seed = std::strtoull(v, nullptr, 10);
+        else if (!std::strcmp(a, "--chunk"))   opt.chunk = std::strtoull(v, nullptr, 10);
+        else if (!std::strcmp(a, "--voxel"))   opt.voxel = (float)std::atof(v);
+        else if (!std::strcmp(a, "--hist"))    opt.hist = v;
+        else if (!std::strcmp(a, "--points"))  opt.points = v;
+        else return false;
+        ++i;
+    }
+    return opt.samples > 0 && opt.chunk > 0 && opt.voxel > 0.0f;
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt))
+    {
+        std::printf("usage: %s [--samples n] [--threads n] [--seed n] [--chunk n]\n"
+                    "          [--voxel metres] [--hist prefix] [--points file.ply]\n", argv[0]);
+        return 1;
+    }
+    if (opt.threads <= 0)
+        opt.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // palm stays within this distance of the shoulder
+    Grid grid;
+    float reach = kUpperArmLen + kForearmLen + kPalmOffset + opt.voxel;
+    uint32_t n = (uint32_t)std::ceil(2.0f * reach / opt.voxel);
+    grid.origin[0] = -reach;
+    grid.origin[1] = kShoulderHeight - reach;
+    grid.origin[2] = -reach;
+    grid.voxel = opt.voxel;
+    grid.dims[0] = grid.dims[1] = grid.dims[2] = n;
+
+    uint64_t chunkCount = (opt.samples + opt.chunk - 1) / opt.chunk;
+    ChunkQueues queues(opt.threads, chunkCount);
+    ArmJointLimits limits = DefaultArmJointLimits();
+
+    PointWriter points;
+    if (!opt.points.empty() && !points.Open(opt.points, opt.samples))
+        return 1;
+
+    std::printf("%llu samples, %llu chunks, %d threads, FK kernel %s\n",
+                (unsigned long long)opt.samples, (unsigned long long)chunkCount, opt.threads,
+                FKKernelName(DetectFKKernel()));
+
+    std::vector<Accum> acc(opt.threads);
+    std::atomic<uint64_t> chunksDone(0);
+    std::atomic<bool> ioError(false);
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < opt.threads; ++t)
+        workers.emplace_back([&, t]() {
+            Accum& a = acc[t];
+            a.envelope.assign((size_t)n * n * n, 0);
+            a.orientation.assign((size_t)kAzimuthBins * kElevationBins, 0);
+            a.clearance.assign(kClearanceBins, 0);
+
+            Scratch scratch;
+
+            uint64_t chunk;
+            bool stolen;
+            while (!ioError && queues.Next(t, chunk, stolen))
+            {
+                SampleChunk(opt, grid, limits, chunk, a, scratch, points, ioError);
+                ++a.chunks;
+                a.stolen += stolen;
+                ++chunksDone;
+            }
+        });
+
+    // progress from the main thread
+    for (;;)
+    {
+        uint64_t done = chunksDone.load();
+        if (done >= chunkCount || ioError)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::printf("\r%5.1f%%", 100.0 * chunksDone.load() / chunkCount);
+        std::fflush(stdout);
+    }
+    for (std::thread& w : workers)
+        w.join();
+    double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("\r       \r");
+
+    if (ioError || (points.IsOpen() && !points.Close()))
+    {
+        std::printf("failed writing %s\n", opt.points.c_str());
+        return 1;
+    }
+
+    // integer counts: the merge is exact whatever the schedule was
+    Accum total = acc[0];
+    for (int t = 1; t < opt.threads; ++t)
+    {
+        for (size_t i = 0; i < total.envelope.size(); ++i)    total.envelope[i] += acc[t].envelope[i];
+        for (size_t i = 0; i < total.orientation.size(); ++i) total.orientation[i] += acc[t].orientation[i];
+        for (size_t i = 0; i < total.clearance.size(); ++i)   total.clearance[i] += acc[t].clearance[i];
+    }
+    if (!WriteHistograms(opt, grid, total))
+        return 1;
+
+    size_t reached = 0;
+    for (uint64_t c : total.envelope)
+        reached += (c != 0);
+    uint64_t belowGround = 0;
+    for (int i = 0; i < kClearanceBins && kClearanceMin + (i + 1) * kClearanceStep <= 0.0f; ++i)
+        belowGround += total.clearance[i];
+
+    std::printf("%.2f s, %.1f M samples/s\n", sec, opt.samples / sec * 1e-6);
+    std::printf("envelope: %zu of %u voxels reached (%.3f m)\n", reached, n * n * n, opt.voxel);
+    std::printf("fingertip below ground in %.2f%% of samples\n", 100.0 * belowGround / opt.samples);
+    for (int t = 0; t < opt.threads; ++t)
+        std::printf("thread %d: %llu chunks (%llu stolen)\n", t,
+                    (unsigned long long)acc[t].chunks, (unsigned long long)acc[t].stolen);
+    return 0;
+}